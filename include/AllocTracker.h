@@ -0,0 +1,22 @@
+#ifndef ALLOCTRACKER_H
+#define ALLOCTRACKER_H
+
+#include <cstdint>
+
+// Counts heap allocations made through operator new, to check that the per-tick and per-frame
+// paths allocate nothing once the game is running. The counting operator new lives in
+// src/AllocHooks.cpp, which executables compile in to enable it; without it every count stays
+// zero and isEnabled() is false. Allocations SDL makes with malloc are not seen.
+namespace AllocTracker {
+
+bool isEnabled();
+uint64_t total();       // Allocations on every thread since startup
+uint64_t thisThread();  // Allocations made by the calling thread
+
+// Called by the hooks
+void enable();
+void count();
+
+}
+
+#endif // ALLOCTRACKER_H
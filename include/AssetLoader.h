@@ -0,0 +1,51 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include "AssetPack.h"
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+// Font, music and sound effects the game needs; any of them may be missing
+struct GameAssets {
+    TTF_Font* font = nullptr;
+    Mix_Music* music = nullptr;
+    Mix_Chunk* moveSound = nullptr;
+    Mix_Chunk* scoreSound = nullptr;
+    Mix_Chunk* gameOverSound = nullptr;
+};
+
+// Loads the game's assets on a background thread so the first frame does not wait for
+// decoding. Assets come from a memory-mapped pack (see AssetPack) when one is found,
+// otherwise from the loose files in assets/ and build/. The font and music keep reading
+// from the pack while in use, so the loader must outlive them.
+class AssetLoader {
+public:
+    AssetLoader();
+    ~AssetLoader(); // Waits for the thread; assets not taken are freed
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // An empty packPath looks for assets.pak next to the executable, then in the working directory
+    void start(const std::string& packPath);
+    bool isReady() const { return ready.load(std::memory_order_acquire); } // Also signalled by an SDL_USEREVENT
+    GameAssets take(); // Waits for loading to finish; the caller frees what it gets
+
+private:
+    std::thread worker;
+    std::atomic<bool> ready;
+    std::string requestedPack;
+    AssetPack pack;
+    GameAssets assets;
+
+    void load();
+    bool openPack();
+    void loadFromPack();
+    void loadLooseFiles();
+};
+
+#endif // ASSETLOADER_H
@@ -0,0 +1,64 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Single-file asset pack: named blobs stored back to back, read through one memory mapping
+// so assets are used in place without copies.
+//
+//   header: "TTPK" | u32 version | u32 entry count | u32 reserved
+//   entry:  u32 name length | name | u64 offset | u64 size   (one per asset)
+//   data:   blobs at their offsets, each aligned to 16 bytes
+//
+// All integers are little endian. Offsets are from the start of the file.
+namespace AssetPackFormat {
+const char MAGIC[4] = {'T', 'T', 'P', 'K'};
+const uint32_t VERSION = 1;
+const size_t ALIGNMENT = 16;
+}
+
+struct AssetData {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+class AssetPack {
+public:
+    bool open(const std::string& path); // Reports a bad pack on std::cerr; a missing one silently
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    AssetData find(const std::string& name) const; // Empty if the pack has no such asset; valid while open
+
+private:
+    struct Entry {
+        std::string name;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    MappedFile file;
+    std::vector<Entry> entries;
+};
+
+// Builds a pack in memory and writes it out in one go
+class AssetPackWriter {
+public:
+    void add(const std::string& name, std::vector<uint8_t> bytes);
+    bool write(const std::string& path) const;
+
+private:
+    struct Asset {
+        std::string name;
+        std::vector<uint8_t> bytes;
+    };
+    std::vector<Asset> assets;
+};
+
+#endif // ASSETPACK_H
@@ -0,0 +1,41 @@
+#ifndef BATCHENV_H
+#define BATCHENV_H
+
+#include "GameCore.h"
+#include "WorkStealingPool.h"
+#include "tetromino_env.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+static_assert(Board::WIDTH == TETROMINO_BOARD_WIDTH && Board::HEIGHT == TETROMINO_BOARD_HEIGHT, "C API board size is out of date");
+
+// Many games stepped in lockstep for training; backs the tetromino_env C API
+class BatchEnv {
+public:
+    BatchEnv(int count, uint32_t seed, unsigned threads, uint32_t ticksPerStep); // Games start reset
+
+    int getCount() const { return static_cast<int>(games.size()); }
+    void setBuffers(const TetrominoEnvBuffers& newBuffers) { buffers = newBuffers; }
+
+    void reset();
+    void step(const uint8_t* actions); // One input mask per game; finished games restart with a new seed
+
+private:
+    std::vector<GameCore> games;
+    std::vector<uint32_t> episodes; // Games finished per slot, to derive fresh seeds
+    TetrominoEnvBuffers buffers;
+    uint32_t seed;
+    uint32_t ticksPerStep;
+    std::unique_ptr<WorkStealingPool> pool; // Null when stepping on the caller's thread
+    int sliceCount;                          // One contiguous range of games per pool item
+    std::function<void(int)> stepSlice;      // Built once, so stepping on the pool allocates nothing
+    const uint8_t* stepActions;              // Actions of the step in progress, for stepSlice
+
+    uint32_t seedFor(int index) const;
+    void stepRange(int first, int last, const uint8_t* actions);
+    void observe(int index);
+};
+
+#endif // BATCHENV_H
@@ -1,26 +1,242 @@
 #ifndef BOARD_H
 #define BOARD_H
 
-#include <vector>
-#include <SDL.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include "Tetromino.h"
+#include "Zobrist.h"
 
-class Board {
+namespace BoardDetail {
+
+// Narrowest unsigned word holding one bit per column
+template <int bytes> struct RowWordOfSize;
+template <> struct RowWordOfSize<1> { using Type = uint8_t; };
+template <> struct RowWordOfSize<2> { using Type = uint16_t; };
+template <> struct RowWordOfSize<4> { using Type = uint32_t; };
+template <> struct RowWordOfSize<8> { using Type = uint64_t; };
+
+template <int width>
+using RowWord = typename RowWordOfSize<width <= 8 ? 1 : width <= 16 ? 2 : width <= 32 ? 4 : 8>::Type;
+
+}
+
+// Playfield of width x height visible cells, with hidden rows stacked above the visible field at
+// y = -hidden .. -1. Pieces may spawn into the hidden rows and cells locked there are kept;
+// anything above them is dropped. The geometry is fixed at compile time, so every loop over
+// rows and columns has a constant trip count.
+template <int width, int height, int hidden = 0>
+class BasicBoard {
 public:
-    static const int WIDTH = 10;
-    static const int HEIGHT = 20;
+    static constexpr int WIDTH = width;
+    static constexpr int HEIGHT = height;
+    static constexpr int HIDDEN = hidden;
+    static constexpr int ROWS = height + hidden; // Stored rows, hidden ones first
 
-    Board();
+    static_assert(width >= 4 && width <= Zobrist::MAX_PIECE_COLUMNS, "a board is 4 to 64 columns wide");
+    static_assert(height > 0 && hidden >= 0 && ROWS <= INT8_MAX, "column tops are stored as int8_t");
+
+    using Row = BoardDetail::RowWord<width>; // One occupancy bit per column, bit x = column x
+    static constexpr Row FULL_ROW = static_cast<Row>(~0ull >> (64 - width));
+
+    BasicBoard();
 
     bool isCollision(const Tetromino& tetromino) const;
+    int dropDistance(const Tetromino& tetromino) const; // Rows the tetromino can fall before it collides
     void addTetromino(const Tetromino& tetromino);
     int clearLines(); // Returns number of lines cleared
+    void addGarbage(int count, int holeX, Color color); // Push the stack up and fill the bottom rows, leaving one hole per row
     void reset();
 
-    const std::vector<std::vector<SDL_Color>>& getGrid() const { return grid; }
+    // y runs from -HIDDEN to HEIGHT - 1
+    bool isOccupied(int x, int y) const { return (rows[y + hidden] >> x) & 1u; }
+    Row getRow(int y) const { return rows[y + hidden]; }
+    const std::array<Row, ROWS>& getRows() const { return rows; } // Hidden rows first
+    int getColumnTop(int x) const { return columnTops[x]; } // Row of the highest occupied cell, HEIGHT if empty
+    uint64_t getHash() const { return hash; } // Zobrist hash of the occupancy (Zobrist.h); colors don't count
+
+    // Colors are only meaningful for occupied cells; only rendering reads them
+    Color getCellColor(int x, int y) const { return colors[(y + hidden) * width + x]; }
 
 private:
-    std::vector<std::vector<SDL_Color>> grid;
+    std::array<Row, ROWS> rows;             // Occupancy bitboard, one word per row
+    std::array<Color, width * ROWS> colors; // Color plane, row-major
+    std::array<int8_t, width> columnTops;   // Height profile, kept in step with rows
+    uint64_t hash;                          // Kept in step with rows
+
+    static uint64_t rowKey(int index, Row row) { return Zobrist::BOARD_KEYS<width, ROWS>.row(index, row); }
+    static Row shapeRow(uint8_t bits, int x) {
+        return static_cast<Row>(x >= 0 ? static_cast<uint64_t>(bits) << x : static_cast<uint64_t>(bits) >> -x);
+    }
+
+    void updateColumnTops();
+    void updateHash();
+    int scanDropDistance(const Tetromino& tetromino) const;
 };
 
+// The standard 10 x 20 field; the game, bots and tools all play on it
+using Board = BasicBoard<10, 20>;
+
+template <int width, int height, int hidden>
+BasicBoard<width, height, hidden>::BasicBoard() {
+    reset();
+}
+
+template <int width, int height, int hidden>
+bool BasicBoard<width, height, hidden>::isCollision(const Tetromino& tetromino) const {
+    const ShapeData& shape = tetromino.getShape();
+    if (shape.cellCount == 0) return false;
+
+    int tetroX = tetromino.getX();
+    int tetroY = tetromino.getY();
+
+    // Check boundaries against the precomputed bounding box
+    if (tetroX + shape.minX < 0 || tetroX + shape.maxX >= width || tetroY + shape.maxY >= height) {
+        return true; // Collision with wall or bottom
+    }
+
+    // Check collision with existing blocks, one mask AND per tetromino row
+    for (int y = shape.minY; y <= shape.maxY; ++y) {
+        int boardY = tetroY + y;
+        if (boardY < -hidden) continue; // Above the hidden rows, e.g. at spawn
+
+        if (rows[boardY + hidden] & shapeRow(shape.rows[y], tetroX)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <int width, int height, int hidden>
+int BasicBoard<width, height, hidden>::dropDistance(const Tetromino& tetromino) const {
+    const ShapeData& shape = tetromino.getShape();
+    if (shape.cellCount == 0) return 0;
+
+    // Fall until the lowest cell of some column lands on that column's surface
+    int distance = ROWS;
+    for (int x = shape.minX; x <= shape.maxX; ++x) {
+        int gap = columnTops[tetromino.getX() + x] - 1 - (tetromino.getY() + shape.bottomY[x]);
+        if (gap < 0) {
+            return scanDropDistance(tetromino); // Tucked under an overhang; the profile can't tell
+        }
+        distance = std::min(distance, gap);
+    }
+    return distance;
+}
+
+template <int width, int height, int hidden>
+int BasicBoard<width, height, hidden>::scanDropDistance(const Tetromino& tetromino) const {
+    Tetromino dropped = tetromino;
+    int distance = 0;
+    while (true) {
+        dropped.move(0, 1);
+        if (isCollision(dropped)) {
+            return distance;
+        }
+        distance++;
+    }
+}
+
+template <int width, int height, int hidden>
+void BasicBoard<width, height, hidden>::addTetromino(const Tetromino& tetromino) {
+    const ShapeData& shape = tetromino.getShape();
+    int tetroX = tetromino.getX();
+    int tetroY = tetromino.getY();
+    Color color = tetromino.getColor();
+
+    for (int i = 0; i < shape.cellCount; ++i) {
+        int boardX = tetroX + shape.cellX[i];
+        int boardY = tetroY + shape.cellY[i];
+        if (boardY < -hidden) continue; // Cells above the hidden rows are lost
+        int index = boardY + hidden;
+
+        Row cell = static_cast<Row>(Row(1) << boardX);
+        if (!(rows[index] & cell)) hash ^= rowKey(index, cell); // A locked piece may overlap at game over
+        rows[index] |= cell;
+        colors[index * width + boardX] = color;
+        if (boardY < columnTops[boardX]) columnTops[boardX] = static_cast<int8_t>(boardY);
+    }
+}
+
+template <int width, int height, int hidden>
+int BasicBoard<width, height, hidden>::clearLines() {
+    // Compact non-full rows towards the bottom in a single pass
+    int writeIndex = ROWS - 1;
+    for (int index = ROWS - 1; index >= 0; --index) {
+        if (rows[index] == FULL_ROW) {
+            hash ^= rowKey(index, FULL_ROW);
+            continue;
+        }
+        if (writeIndex != index) {
+            hash ^= rowKey(index, rows[index]) ^ rowKey(writeIndex, rows[index]); // Row moves down
+            rows[writeIndex] = rows[index];
+            std::copy(colors.begin() + index * width, colors.begin() + (index + 1) * width, colors.begin() + writeIndex * width);
+        }
+        writeIndex--;
+    }
+
+    int linesCleared = writeIndex + 1;
+    // Clear the rows vacated at the top
+    for (int index = writeIndex; index >= 0; --index) {
+        rows[index] = 0;
+    }
+    if (linesCleared > 0) {
+        updateColumnTops();
+    }
+    return linesCleared;
+}
+
+template <int width, int height, int hidden>
+void BasicBoard<width, height, hidden>::addGarbage(int count, int holeX, Color color) {
+    count = std::min(std::max(count, 0), height);
+
+    // Shift everything up; rows pushed past the top are lost
+    for (int index = 0; index + count < ROWS; ++index) {
+        rows[index] = rows[index + count];
+        std::copy(colors.begin() + (index + count) * width, colors.begin() + (index + count + 1) * width, colors.begin() + index * width);
+    }
+
+    Row garbage = FULL_ROW & static_cast<Row>(~(Row(1) << holeX));
+    for (int index = ROWS - count; index < ROWS; ++index) {
+        rows[index] = garbage;
+        std::fill(colors.begin() + index * width, colors.begin() + (index + 1) * width, color);
+    }
+    updateColumnTops();
+    updateHash();
+}
+
+template <int width, int height, int hidden>
+void BasicBoard<width, height, hidden>::reset() {
+    rows.fill(0);
+    colors.fill({0, 0, 0, 0});
+    columnTops.fill(height);
+    hash = Zobrist::BOARD_KEYS<width, ROWS>.emptyBoard;
+}
+
+template <int width, int height, int hidden>
+void BasicBoard<width, height, hidden>::updateColumnTops() {
+    // Walk down from the top; each column's first occupied cell is its top
+    columnTops.fill(height);
+    Row seen = 0;
+    for (int index = 0; index < ROWS && seen != FULL_ROW; ++index) {
+        Row fresh = rows[index] & ~seen;
+        while (fresh) {
+            columnTops[__builtin_ctzll(fresh)] = static_cast<int8_t>(index - hidden);
+            fresh &= fresh - 1;
+        }
+        seen |= rows[index];
+    }
+}
+
+template <int width, int height, int hidden>
+void BasicBoard<width, height, hidden>::updateHash() {
+    hash = Zobrist::BOARD_KEYS<width, ROWS>.emptyBoard;
+    for (int index = 0; index < ROWS; ++index) {
+        hash ^= rowKey(index, rows[index]);
+    }
+}
+
+// Compiled once in Board.cpp rather than in every file that uses the standard board
+extern template class BasicBoard<10, 20>;
+
 #endif // BOARD_H
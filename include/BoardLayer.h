@@ -0,0 +1,41 @@
+#ifndef BOARDLAYER_H
+#define BOARDLAYER_H
+
+#include "Board.h"
+#include "CellBatch.h"
+#include <cstdint>
+#include <SDL.h>
+
+// The locked stack and the border drawn once into a render target texture, so a frame costs
+// one texture copy instead of a rectangle per cell. The texture is redrawn only when the
+// board revision (see GameCore::getBoardRevision) or the cell size changes.
+// Renderers without render target support fall back to drawing the cells every frame.
+class BoardLayer {
+public:
+    BoardLayer();
+    ~BoardLayer();
+
+    BoardLayer(const BoardLayer&) = delete;
+    BoardLayer& operator=(const BoardLayer&) = delete;
+
+    // Draws the board with its top left corner at x, y. batch must be begun on renderer.
+    void draw(SDL_Renderer* renderer, CellBatch& batch, const Board& board, uint64_t revision, int cellSize, int x, int y);
+    void invalidate() { valid = false; } // Texture contents were lost (SDL_RENDER_TARGETS_RESET)
+
+    void setCached(bool enabled); // Off draws every cell every frame, for comparisons
+    bool isCached() const { return cached; }
+
+private:
+    SDL_Renderer* owner; // Renderer the texture belongs to
+    SDL_Texture* texture;
+    int textureCellSize;
+    uint64_t textureRevision;
+    bool valid;
+    bool cached;
+
+    static void drawCells(SDL_Renderer* renderer, CellBatch& batch, const Board& board, int cellSize, int x, int y);
+    bool prepare(SDL_Renderer* renderer, int cellSize); // (Re)creates the texture; false if targets are unsupported
+    void release();
+};
+
+#endif // BOARDLAYER_H
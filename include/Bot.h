@@ -0,0 +1,99 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include "Board.h"
+#include "GameCore.h"
+#include "MoveGenerator.h"
+#include "TranspositionTable.h"
+#include <cstdint>
+#include <vector>
+
+// Heuristic weights; features are penalties, so their weights are negative
+struct EvalWeights {
+    float aggregateHeight = -0.510066f;
+    float holes = -0.35663f;
+    float bumpiness = -0.184483f;
+    float wells = -0.1f;
+    float linesCleared = 0.760666f;
+};
+
+struct BoardFeatures {
+    int aggregateHeight; // Sum of column heights
+    int holes;           // Empty cells with a filled cell somewhere above them
+    int bumpiness;       // Sum of height differences between neighbouring columns
+    int wells;           // Sum of depths of columns lower than both neighbours (walls count as full)
+};
+
+BoardFeatures computeFeatures(const Board& board);
+float evaluate(const BoardFeatures& features, int linesCleared, const EvalWeights& weights);
+
+struct BotConfig {
+    EvalWeights weights;
+    int beamWidth = 8;
+    int depth = 2;                     // Pieces to look ahead; only current, next and held are known
+    uint32_t timeBudgetMicros = 20000; // Per-move search budget; the first piece is always searched fully
+    TranspositionTable* table = nullptr; // Optional cache of board features by board hash, may be shared between bots
+};
+
+struct BotDecision {
+    bool found = false;
+    bool useHold = false; // Press hold first, then place the swapped-in piece
+    Placement placement = {TetrominoType::None, 0, 0, 0};
+    float score = 0.0f;
+};
+
+// Autoplay bot: beam search over placements of the current piece, the next piece and the hold option
+class Bot {
+public:
+    explicit Bot(const BotConfig& config = BotConfig());
+
+    BotDecision think(const GameCore& game);
+
+    // Controller for driving a game one step at a time: plans when a new piece appears and
+    // returns the next input on the path to the planned placement
+    Input nextInput(const GameCore& game);
+
+    const BotConfig& getConfig() const { return config; }
+
+private:
+    struct Node {
+        Board board;
+        Tetromino held;
+        int queueIndex; // Next unplaced piece in {current, next}
+        int lines;
+        float score;
+        bool firstUseHold;
+        Placement firstPlacement;
+    };
+
+    BotConfig config;
+    std::vector<Node> beam;
+    std::vector<Node> candidates;
+    std::vector<int> order;     // Candidate indices by score, for keepBest
+    std::vector<uint64_t> kept; // Hashes of the nodes kept so far, for keepBest
+    std::vector<const Board*> batchBoards; // Candidate boards and their features, for scoreCandidates
+    std::vector<int16_t> batchFeatures;    // BATCH_FEATURES arrays of candidates.size() entries
+    PlacementList placements;
+
+    BotDecision plan;
+    int planPiece; // Pieces placed when the plan was made
+    bool planHeld; // Whether the plan's hold has been pressed
+
+    // Input path to the planned placement, with the position hash (GameCore::getPositionHash)
+    // expected before each input. While the game follows it, no new path search is needed.
+    static const int MAX_PATH = 64;
+    Input path[MAX_PATH];
+    uint64_t pathHashes[MAX_PATH];
+    int pathLength;
+    int pathStep; // Next input to send
+
+    static const size_t BATCH_FEATURES = 7; // Arrays in a FeatureArrays, not counting heights
+
+    BoardFeatures features(const Board& board);
+    void scoreCandidates(); // Evaluates every candidate board, in one batch when the CPU has a vector kernel
+    void keepBest();
+    void expand(const Node& node, const Tetromino& start, const Tetromino& held, int queueIndex, bool useHold, bool root);
+    bool findPath(const GameCore& game); // Path from the current piece to the planned placement
+};
+
+#endif // BOT_H
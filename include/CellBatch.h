@@ -0,0 +1,39 @@
+#ifndef CELLBATCH_H
+#define CELLBATCH_H
+
+#include "Board.h"
+#include "Tetromino.h"
+#include <vector>
+#include <SDL.h>
+
+inline SDL_Color toSDLColor(Color color) {
+    return {color.r, color.g, color.b, color.a};
+}
+
+// Collects filled cell rectangles per color and draws each color with one SDL_RenderFillRects call.
+// In immediate mode every cell is drawn as it is added (one color change and fill per cell),
+// which is the old path and is kept for comparisons.
+class CellBatch {
+public:
+    CellBatch();
+
+    void begin(SDL_Renderer* renderer); // Start collecting for this renderer
+    void add(SDL_Color color, const SDL_Rect& rect);
+    void addBoard(const Board& board, int cellSize, int x, int y); // Every locked cell, top left corner at x, y
+    void flush(); // Draw everything collected so far, one call per color
+
+    void setImmediate(bool enabled) { immediate = enabled; }
+    bool isImmediate() const { return immediate; }
+
+private:
+    struct Bucket {
+        SDL_Color color;
+        std::vector<SDL_Rect> rects; // Capacity is kept between frames
+    };
+
+    SDL_Renderer* renderer;
+    std::vector<Bucket> buckets;
+    bool immediate;
+};
+
+#endif // CELLBATCH_H
@@ -0,0 +1,29 @@
+#ifndef FEATUREBATCH_H
+#define FEATUREBATCH_H
+
+#include "Board.h"
+#include <cstddef>
+#include <cstdint>
+
+// Caller-owned structure-of-arrays output of computeFeatureBatch; every array holds one entry
+// per board, except heights, which holds Board::WIDTH per board (board-major) and may be null.
+// Features match computeFeatures (Bot.h) where both have them.
+struct FeatureArrays {
+    uint8_t* heights;           // Per column, counting up from the floor
+    int16_t* aggregateHeight;   // Sum of column heights
+    int16_t* holes;             // Empty cells with a filled cell somewhere above them
+    int16_t* bumpiness;         // Sum of height differences between neighbouring columns
+    int16_t* wells;             // Sum of depths of columns lower than both neighbours (walls count as full)
+    int16_t* rowTransitions;    // Filled/empty changes along every row; walls count as filled
+    int16_t* columnTransitions; // Filled/empty changes down every column; the floor counts as filled
+    int16_t* completedLines;    // Full rows, not yet cleared
+};
+
+// Features of many boards at once, e.g. every placement of one piece. Picks the widest kernel
+// the CPU supports the first time it is called: AVX2 (16 boards per pass) or portable scalar.
+void computeFeatureBatch(const Board* const* boards, size_t count, const FeatureArrays& out);
+void computeFeatureBatchScalar(const Board* const* boards, size_t count, const FeatureArrays& out);
+const char* featureBatchKernel();  // "avx2" or "scalar"
+bool featureBatchIsVectorized();   // Whether the batch beats computeFeatures board by board
+
+#endif // FEATUREBATCH_H
@@ -0,0 +1,108 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Phases of one pass through the main loop
+enum class FramePhase : uint8_t {
+    Events,        // Draining the SDL event queue (not the idle wait before it)
+    Input,         // Game::handleInput
+    Update,        // Game::update: latest snapshot, audio (the game ticks on its own thread); wall stepping
+    RenderBoard,   // Locked cells and border
+    RenderGhost,
+    RenderPieces,  // Falling piece and the next/hold previews
+    RenderText,    // HUD labels and score
+    RenderOverlay, // Pause/game over screens and the profiler overlay
+    Present,       // SDL_RenderPresent, including any vsync wait
+    Count
+};
+
+// Times the phases of each frame with a monotonic high-resolution clock. Keeps the last
+// HISTORY frames for rolling percentiles and can record every phase as a Chrome trace
+// (chrome://tracing or Perfetto) to find which phase a hitch came from.
+//
+// A pass of the main loop that handles events and updates but draws nothing is not a frame:
+// frame times and the render phases cover drawn frames only, while Events, Input, Update and
+// allocations are kept for every pass, so their time is neither lost nor added to a frame.
+class FrameProfiler {
+public:
+    static const int PHASE_COUNT = static_cast<int>(FramePhase::Count);
+    static constexpr int HISTORY = 240; // Frames in the rolling window
+
+    FrameProfiler();
+    ~FrameProfiler(); // Writes an unfinished trace
+
+    static const char* phaseName(FramePhase phase);
+
+    void beginFrame(); // Starts a pass of the main loop; drops phase times of one that was never ended
+    void endPass();    // Ends a pass that drew nothing: only its Events, Input and Update times and allocations count
+    void endFrame();   // Ends a pass that drew a frame and commits it to the rolling window
+
+    void begin(FramePhase phase);
+    void end(FramePhase phase); // A phase may run several times a frame; the times add up
+
+    // Milliseconds at the given percentile (0-100) over the rolling window
+    double framePercentile(double percentile) const;
+    double phasePercentile(FramePhase phase, double percentile) const; // Over passes for Events, Input and Update
+    int getFrameCount() const { return frameCount; } // Frames in the window
+    // Heap allocations the last HISTORY passes made on the profiling thread (AllocTracker.h);
+    // zero in play, except while tracing
+    uint64_t windowAllocations() const;
+
+    bool startTrace(const std::string& path);
+    bool stopTrace(); // Writes the trace file
+    bool isTracing() const { return tracing; }
+
+    // Times a phase for the lifetime of the scope; does nothing without a profiler
+    class Scope {
+    public:
+        Scope(FrameProfiler* profiler, FramePhase phase) : profiler(profiler), phase(phase) {
+            if (profiler) profiler->begin(phase);
+        }
+        ~Scope() {
+            if (profiler) profiler->end(phase);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameProfiler* profiler;
+        FramePhase phase;
+    };
+
+private:
+    static const size_t MAX_TRACE_EVENTS = 4000000; // About 100 MB of JSON
+
+    struct TraceEvent {
+        uint64_t start; // Nanoseconds since the trace started
+        uint32_t duration;
+        uint8_t phase;  // PHASE_COUNT marks a whole frame
+    };
+
+    uint64_t frameStart;
+    uint64_t phaseStart[PHASE_COUNT];
+    uint64_t phaseTotal[PHASE_COUNT]; // Nanoseconds in the current frame
+
+    float frameHistory[HISTORY]; // Milliseconds, ring buffers indexed by frame, or by pass for pass phases
+    float phaseHistory[PHASE_COUNT][HISTORY];
+    uint32_t allocationHistory[HISTORY]; // Indexed by pass
+    uint64_t frameAllocationStart;
+    int nextFrame;
+    int frameCount;
+    int nextPass;
+    int passCount;
+
+    bool tracing;
+    std::string tracePath;
+    uint64_t traceStart;
+    std::vector<TraceEvent> trace;
+
+    static uint64_t now();
+    static bool isPassPhase(int phase) { return phase <= static_cast<int>(FramePhase::Update); }
+    void addTraceEvent(uint64_t start, uint64_t end, uint8_t phase);
+    static double percentileOf(const float* samples, int count, double percentile);
+};
+
+#endif // FRAMEPROFILER_H
@@ -0,0 +1,38 @@
+#ifndef FRAMERASTERIZER_H
+#define FRAMERASTERIZER_H
+
+#include "RenderSnapshot.h"
+#include <cstdint>
+
+// Software rasterizer for headless video export: draws a RenderSnapshot into a memory
+// framebuffer with the layout Game::render uses for the same size, without SDL or a GPU.
+// Labels use a built-in 5x7 pixel font instead of the game's TTF font.
+// draw() is const, so any number of threads can share one rasterizer.
+class FrameRasterizer {
+public:
+    FrameRasterizer(int width, int height, int cellSize = 0); // 0 = fit the board like the window does
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getCellSize() const { return cellSize; }
+
+    // Pixels are 0x00BBGGRR words (R, G, B, unused bytes in memory), row-major, width * height
+    void draw(const RenderSnapshot& state, uint32_t* pixels) const;
+
+    // BT.601 limited-range 4:2:0: a width * height Y plane, then U and V planes at half size
+    // (rounded up). Chroma is the average of each 2x2 block.
+    static void toYuv420(const uint32_t* pixels, int width, int height, uint8_t* out);
+    static size_t yuv420Size(int width, int height);
+
+private:
+    int width, height;
+    int cellSize;
+
+    void fill(uint32_t* pixels, int x, int y, int w, int h, Color color) const;
+    void blend(uint32_t* pixels, int x, int y, int w, int h, Color color, int alpha) const; // Over what is there
+    void outline(uint32_t* pixels, int x, int y, int w, int h, Color color) const;
+    void drawPiece(uint32_t* pixels, const Tetromino& piece, int x, int y, int size) const;
+    int drawText(uint32_t* pixels, const char* text, int x, int y, Color color) const; // Returns the end x
+};
+
+#endif // FRAMERASTERIZER_H
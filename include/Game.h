@@ -1,57 +1,94 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include "Board.h"
-#include "Tetromino.h"
-#include <random>
+#include "AssetLoader.h"
+#include "BoardLayer.h"
+#include "CellBatch.h"
+#include "FrameProfiler.h"
+#include "GameSimulation.h"
+#include "TextRenderer.h"
+#include <SDL.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h> // Include SDL_mixer
+#include <atomic>
 
+// SDL frontend over a GameSimulation: maps key events to commands, plays audio and renders the
+// newest snapshot. The game itself runs on the simulation's thread once start() is called.
 class Game {
 public:
-    Game();
+    // Same seed and inputs on the same ticks replay the same game. Assets load in the
+    // background from assetPack, or from the default locations if it is empty.
+    explicit Game(uint32_t seed, const std::string& assetPack = "");
     ~Game(); // Destructor to clean up font and mixer
 
-    void handleInput(SDL_Event& event);
-    void update();
+    void start(); // Starts the simulation thread; the setup calls below come before it
+    void handleInput(SDL_Event& event); // Forwards the input to the simulation for its next tick
+    void update(); // Takes the newest snapshot and plays its sounds
+    void waitForAssets(); // Blocks until the font and sounds are in use
     void render(SDL_Renderer* renderer, int cellSize); // Added cellSize parameter
 
-    bool isGameOver() const { return gameOver; }
-    int getScore() const { return score; }
-    int getLevel() const { return level; }
+    // Frame pacing: the main loop sleeps until an event arrives; every new snapshot posts one
+    bool needsRender() const { return dirty; } // Something visible changed since the last render
+    void requestRender() { dirty = true; }      // E.g. the window was exposed or resized
+
+    void setAutoplay(bool enabled) { sim.setAutoplay(enabled); } // Let the bot play; A toggles it once started
+
+    // Draw cells in per-color batches (default) or one fill call per cell
+    void setBatchedRendering(bool enabled) { batch.setImmediate(!enabled); }
+    // Draw the locked stack from a texture redrawn only when it changes (default), or cell by cell
+    void setCachedBoard(bool enabled) { boardLayer.setCached(enabled); }
+    void addGarbage(int count, int holeX, Color color); // Before start()
+
+    // Sessions are recorded as replays; playback re-simulates one as fast as frames are drawn,
+    // ticksPerFrame ticks per frame. Both before start().
+    bool startRecording(const std::string& path) { return sim.startRecording(path); }
+    bool startPlayback(const std::string& path, int ticksPerFrame);
+    bool isPlayingBack() const { return snapshot().playingBack; }
+
+    // Times the render phases; F3 shows rolling frame times, F4 starts/stops a trace
+    void setProfiler(FrameProfiler* frameProfiler) { profiler = frameProfiler; }
+
+    bool isGameOver() const { return snapshot().gameOver; }
+    int getScore() const { return snapshot().score; }
+    int getLevel() const { return snapshot().level; }
 
 private:
-    Board board;
-    Tetromino currentTetromino;
-    Tetromino nextTetromino;
-    Tetromino heldTetromino; // New: for holding pieces
+    GameSimulation sim;
+    Uint32 snapshotEvent;            // Posted by the simulation thread when it publishes
+    std::atomic<bool> snapshotPosted; // One posted event at a time, however far rendering lags
+
+    // Sound state of the last snapshot taken, to play what happened since
+    uint32_t heardMoves;
+    uint32_t heardClears;
+    bool wasPaused;
+    bool wasGameOver;
 
-    int score;
-    int level;
-    bool gameOver;
-    bool paused; // New: for pause menu
-    bool canSwap; // New: to limit swapping to once per piece
+    FrameProfiler* profiler; // Not owned; may be null
+    bool showProfiler;
 
-    Uint32 lastFallTime;
-    Uint32 fallDelay;
+    bool dirty;
 
-    std::mt19937 rng; // Random number generator
+    AssetLoader loader; // Outlives the assets below, which may read from its pack
+    bool assetsLoaded;
     TTF_Font* font; // Font for rendering text
+    TextRenderer text; // Cached labels and glyph atlas for the HUD
+    CellBatch batch;   // Cell rectangles grouped by color for the current frame
+    BoardLayer boardLayer;
     Mix_Music* backgroundMusic; // Background music
     Mix_Chunk* moveSound;       // Sound for movement
     Mix_Chunk* scoreSound;      // Sound for scoring points
     Mix_Chunk* gameOverSound;   // Sound for game over
 
-    void spawnTetromino();
-    bool moveTetromino(int dx, int dy);
-    void rotateTetromino();
-    void lockTetromino();
-    void updateScore(int linesCleared);
-    void checkGameOver();
-    void renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color); // Helper for rendering text
-    void renderNextTetromino(SDL_Renderer* renderer, int cellSize, int xOffset, int yOffset); // Helper for next tetromino
-    void renderHeldTetromino(SDL_Renderer* renderer, int cellSize, int xOffset, int yOffset); // New: Helper for held tetromino
-    void swapTetromino(); // New: for swapping pieces
+    const RenderSnapshot& snapshot() const { return sim.getSnapshot(); }
+    void takeSnapshot(); // Makes the newest snapshot current and plays its effects
+    void adoptAssets(); // Takes over what the loader loaded and starts the music
+    void playEffects(const RenderSnapshot& current); // Sounds and music for what happened since the last snapshot
+    void beginPhase(FramePhase phase) { if (profiler) profiler->begin(phase); }
+    void endPhase(FramePhase phase) { if (profiler) profiler->end(phase); }
+    void renderProfiler(SDL_Renderer* renderer); // Frame time overlay
+    void renderScore(SDL_Renderer* renderer, int value, int x, int y); // "Score: N" from cached label and glyph atlas
+    void renderNextTetromino(int cellSize, int xOffset, int yOffset); // Adds the next tetromino's cells to the batch
+    void renderHeldTetromino(int cellSize, int xOffset, int yOffset); // Adds the held tetromino's cells to the batch
 };
 
-#endif // GAME_H
\ No newline at end of file
+#endif // GAME_H
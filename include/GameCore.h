@@ -0,0 +1,114 @@
+#ifndef GAMECORE_H
+#define GAMECORE_H
+
+#include "Board.h"
+#include "Tetromino.h"
+#include <cstdint>
+#include <random>
+
+// Player inputs for one step, combined as a bitmask
+enum class Input : uint8_t {
+    None = 0,
+    Left = 1 << 0,
+    Right = 1 << 1,
+    SoftDrop = 1 << 2,
+    Rotate = 1 << 3,
+    HardDrop = 1 << 4,
+    Hold = 1 << 5,
+    Pause = 1 << 6
+};
+
+inline Input operator|(Input a, Input b) { return static_cast<Input>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b)); }
+inline bool hasInput(Input mask, Input bit) { return (static_cast<uint8_t>(mask) & static_cast<uint8_t>(bit)) != 0; }
+
+// What happened during a step, so frontends can react (sounds, redraws)
+struct StepResult {
+    int linesCleared = 0;      // Lines cleared by pieces locked this step
+    bool locked = false;       // A piece was locked this step
+    bool gameOver = false;     // The game ended this step
+    bool pauseToggled = false; // Pause state flipped this step
+};
+
+// Rules and state machine of a single game, with no SDL, rendering or audio dependency.
+// Time advances in fixed ticks supplied by the caller, so the same seed and the same
+// inputs on the same ticks always give the same game, at any speed or frame rate.
+class GameCore {
+public:
+    static const uint32_t TICKS_PER_SECOND = 60;
+
+    // Pacing shared by the real-time frontends
+    static constexpr int AUTOPLAY_INPUT_TICKS = 2; // Ticks between bot inputs, so its moves stay visible
+    static constexpr int MAX_CATCH_UP_TICKS = 15;  // After a stall, drop time beyond this instead of fast-forwarding
+
+    explicit GameCore(uint32_t seed = 0);
+
+    void reset(uint32_t seed);
+
+    // Apply input, then advance the clock by ticks (0 applies the input without time passing)
+    StepResult step(Input input, uint32_t ticks = 1);
+
+    // Insert garbage rows under the stack; ends the game if the current piece no longer fits
+    void addGarbage(int count, int holeX, Color color);
+
+    // Tetromino moved to the spawn point at the top center, keeping its rotation
+    static Tetromino atSpawn(const Tetromino& tetromino);
+
+    const Board& getBoard() const { return board; }
+    const Tetromino& getCurrentTetromino() const { return currentTetromino; }
+    const Tetromino& getNextTetromino() const { return nextTetromino; }
+    const Tetromino& getHeldTetromino() const { return heldTetromino; }
+    int getDropDistance() const; // Rows the current piece can fall; cached until it moves or the board changes
+    uint64_t getBoardRevision() const { return boardRevision; } // Changes whenever the locked cells may have
+    uint64_t getPositionHash() const; // Zobrist hash of the locked cells, current piece and held piece
+
+    bool isGameOver() const { return gameOver; }
+    bool isPaused() const { return paused; }
+    bool canHold() const { return canSwap; }
+    int getScore() const { return score; }
+    int getLevel() const { return level; }
+    uint32_t getSeed() const { return seed; }
+    uint64_t getTick() const { return tick; } // Ticks stepped since reset, paused ones included
+    uint32_t getFallDelay() const { return fallDelay; } // In ticks
+    uint32_t getTicksUntilFall() const { return fallDelay - fallTimer; } // Gravity moves the piece on that tick
+
+    // Statistics for headless runs
+    int getPiecesPlaced() const { return piecesPlaced; }
+    int getLinesCleared() const { return totalLinesCleared; }
+    int getClearCount(int lines) const { return clearCounts[lines - 1]; } // Locks that cleared 1-4 lines
+
+private:
+    Board board;
+    Tetromino currentTetromino;
+    Tetromino nextTetromino;
+    Tetromino heldTetromino;
+
+    int score;
+    int level;
+    bool gameOver;
+    bool paused;
+    bool canSwap; // To limit swapping to once per piece
+
+    int piecesPlaced;
+    int totalLinesCleared;
+    int clearCounts[4];
+
+    uint32_t seed;
+    uint64_t tick;
+    uint32_t fallTimer; // Ticks since gravity last moved the piece
+    uint32_t fallDelay;
+
+    mutable int dropDistance; // -1 when stale
+    uint64_t boardRevision;
+
+    std::mt19937 rng; // Random number generator; its output sequence is fixed by the standard
+
+    TetrominoType randomType();
+    void spawnTetromino(StepResult& result);
+    bool moveTetromino(int dx, int dy);
+    void rotateTetromino();
+    void lockTetromino(StepResult& result);
+    void updateScore(int linesCleared);
+    void swapTetromino(StepResult& result);
+};
+
+#endif // GAMECORE_H
@@ -0,0 +1,66 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include "GameCore.h"
+#include "ServerProtocol.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ServerOptions {
+    std::string socketPath; // Unix domain socket; used unless port is set
+    int port = 0;           // Loopback TCP port
+    unsigned threads = 0;   // Worker threads; 0 = one per hardware thread
+    int statsSeconds = 5;   // Interval of the stats line; 0 = none
+};
+
+// Hosts one game per connection (see ServerProtocol). The calling thread accepts connections
+// and hands each to one of a fixed set of workers, round robin. Every worker runs its own
+// epoll loop over its connections, so no session has a thread of its own and no lock is
+// taken on the input path. Linux only.
+class GameServer {
+public:
+    explicit GameServer(const ServerOptions& options);
+    ~GameServer(); // Stops the workers and closes every connection
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    bool start(); // Binds and starts the workers; reports failures on std::cerr
+    void run(const std::atomic<bool>& stop); // Accepts connections until stop is set
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    struct Connection;
+
+    struct Worker {
+        int epoll = -1;
+        int wakeup = -1; // eventfd signalled when connections are handed over
+        std::thread thread;
+        std::mutex inboxMutex;
+        std::vector<int> inbox; // Accepted sockets not yet registered; guarded by inboxMutex
+        std::vector<Connection*> connections; // Owned; only touched by the worker's thread
+        std::atomic<uint64_t> sessions{0};
+        std::atomic<uint64_t> inputs{0};
+    };
+
+    ServerOptions options;
+    int listener;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> stopping;
+
+    void workerLoop(Worker& worker);
+    void acceptAll(unsigned& nextWorker);
+    bool readFrom(Worker& worker, Connection& connection); // False once the connection should close
+    bool handleFrame(Worker& worker, Connection& connection, const uint8_t* frame);
+    bool flush(Worker& worker, Connection& connection); // False once the connection should close
+    void closeConnection(Worker& worker, Connection* connection);
+    void printStats(uint64_t& lastInputs, double& lastCpu, double elapsedSeconds);
+};
+
+#endif // GAMESERVER_H
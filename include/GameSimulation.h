@@ -0,0 +1,102 @@
+#ifndef GAMESIMULATION_H
+#define GAMESIMULATION_H
+
+#include "Bot.h"
+#include "GameCore.h"
+#include "RenderSnapshot.h"
+#include "Replay.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Requests from the UI thread to the simulation thread
+struct SimCommand {
+    enum class Kind : uint8_t {
+        Input,         // Apply input on a coming tick, one input per tick
+        ToggleAutoplay
+    };
+    Kind kind;
+    Input input;
+};
+
+// Runs one game on its own thread at the fixed tick rate, with the bot, replay recording and
+// playback, and publishes a RenderSnapshot whenever something visible changed. The UI thread
+// sends commands through a wait-free queue and reads the newest snapshot from a triple buffer,
+// so however long a frame takes to draw or present, the game's ticks stay on time.
+//
+// Setup calls (recording, playback, autoplay, garbage) are made before start(), on the thread
+// that reads the snapshots.
+class GameSimulation {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit GameSimulation(uint32_t seed); // Publishes the first snapshot
+    ~GameSimulation(); // Stops the thread; a session not finished is recorded as ending here
+
+    GameSimulation(const GameSimulation&) = delete;
+    GameSimulation& operator=(const GameSimulation&) = delete;
+
+    bool startRecording(const std::string& path) { return recorder.open(path, core.getSeed()); }
+    bool startPlayback(const std::string& path, int ticksPerFrame); // ticksPerFrame ticks per snapshot
+    void setAutoplay(bool enabled) { autoplay = enabled; }
+    void addGarbage(int count, int holeX, Color color);
+
+    // Runs ticks on the calling thread right away, publishing as the simulation thread would.
+    // Lets headless checks drive the real tick path; never called after start().
+    void advance(uint32_t ticks);
+
+    // Runs the game on its own thread; onPublish is called on that thread after every new snapshot
+    void start(std::function<void()> onPublish);
+    void stop();
+
+    bool send(const SimCommand& command); // Wait-free; false if the queue is full and the command was dropped
+
+    // Makes the newest published snapshot current; false if there was none since the last call.
+    // During playback the next snapshot is only made once this one has been taken, so playback
+    // runs as fast as frames are drawn.
+    bool acquireSnapshot();
+    const RenderSnapshot& getSnapshot() const { return snapshots.front(); }
+
+private:
+    GameCore core;
+    Bot bot;
+    bool autoplay;
+    int ticksSinceAutoplay;
+    SpscQueue<Input, 256> pendingInputs; // Drained from the command queue, applied one per tick; a fixed ring, only this thread uses it
+
+    ReplayWriter recorder;
+    ReplayReader replay;
+    ReplayPlayer player; // Reads from replay
+    int playbackTicks;   // 0 unless playing back
+
+    uint32_t moveSounds;
+    uint32_t clearSounds;
+    bool changed; // Something visible changed since the last snapshot
+
+    TripleBuffer<RenderSnapshot> snapshots;
+    SpscQueue<SimCommand, 256> commands;
+    std::function<void()> onPublish;
+
+    std::thread thread;
+    std::atomic<bool> stopping;
+    std::mutex wakeMutex; // Only for sleeping; the queue and snapshots need no lock
+    std::condition_variable wake;
+    bool woken; // Guarded by wakeMutex
+
+    void run();
+    void drainCommands();
+    void tick(); // One fixed step of the game
+    void advancePlayback();
+    void publish();
+    void sleep(const Clock::time_point* until); // Until the deadline (or forever if null), stop or notify
+    void notify();
+};
+
+#endif // GAMESIMULATION_H
@@ -0,0 +1,70 @@
+#ifndef GAMEWALL_H
+#define GAMEWALL_H
+
+#include "AssetLoader.h"
+#include "Bot.h"
+#include "CellBatch.h"
+#include "FrameProfiler.h"
+#include "GameCore.h"
+#include "Replay.h"
+#include "TextRenderer.h"
+#include "WorkStealingPool.h"
+#include <SDL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Spectator wall: many bot games and replays tiled in one window. Boards are stepped in
+// parallel on a work-stealing pool, and every board's cells go into one shared batch, so a
+// frame costs a fill call per color and layer however many boards there are.
+class GameWall {
+public:
+    explicit GameWall(unsigned threadCount = 0, const std::string& assetPack = ""); // 0 = one thread per core
+    ~GameWall();
+
+    GameWall(const GameWall&) = delete;
+    GameWall& operator=(const GameWall&) = delete;
+
+    void addBot(uint32_t seed); // Restarts with a new seed a few seconds after each game over
+    bool addReplay(const std::string& path); // Stays on its final board once played
+    size_t getBoardCount() const { return boards.size(); }
+
+    void update(); // Steps every board by the fixed ticks due since the last update
+    void render(SDL_Renderer* renderer); // Tiles the boards over the whole output
+
+    void setProfiler(FrameProfiler* frameProfiler) { profiler = frameProfiler; }
+
+private:
+    struct WallBoard {
+        GameCore core;
+        Bot bot;
+        int ticksSinceInput = 0;
+        uint32_t restartDelay = 0; // Ticks left showing a finished bot game
+        std::unique_ptr<ReplayReader> replay; // Null for bot boards
+        std::unique_ptr<ReplayPlayer> player;
+
+        WallBoard(uint32_t seed, const BotConfig& config) : core(seed), bot(config) {}
+    };
+
+    std::vector<std::unique_ptr<WallBoard>> boards; // Pointers stay put for the jobs and players
+    WorkStealingPool pool;
+
+    // Fixed-timestep clock, as in Game
+    Uint64 tickLength;
+    Uint64 lastCounter;
+    Uint64 accumulator;
+
+    AssetLoader loader; // Outlives the font, which may read from its pack
+    TTF_Font* font;
+    TextRenderer text;
+    CellBatch batch;
+    std::vector<SDL_Rect> borders[2]; // Running and finished boards, drawn in one call each
+    FrameProfiler* profiler; // Not owned; may be null
+
+    void step(WallBoard& board, uint32_t ticks); // Runs on a pool thread
+    void takeFont();
+    void beginPhase(FramePhase phase) { if (profiler) profiler->begin(phase); }
+    void endPhase(FramePhase phase) { if (profiler) profiler->end(phase); }
+};
+
+#endif // GAMEWALL_H
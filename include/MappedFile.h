@@ -0,0 +1,34 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. Memory-mapped where the platform allows, so the data is
+// paged in from the page cache on demand; otherwise the file is read into memory.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // False if the file can't be opened; nothing is reported. sequential hints that it will be read front to back.
+    bool open(const std::string& path, bool sequential = false);
+    void close();
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+    bool isOpen() const { return bytes != nullptr; }
+
+private:
+    const uint8_t* bytes;
+    size_t length;
+    bool mapped; // Otherwise bytes points into fallback
+    std::vector<uint8_t> fallback;
+};
+
+#endif // MAPPEDFILE_H
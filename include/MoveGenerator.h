@@ -0,0 +1,59 @@
+#ifndef MOVEGENERATOR_H
+#define MOVEGENERATOR_H
+
+#include "Board.h"
+#include "GameCore.h"
+#include "Tetromino.h"
+#include <cassert>
+#include <cstdint>
+
+// Final resting position of a piece
+struct Placement {
+    TetrominoType type;
+    uint8_t rotation;
+    int8_t x, y;
+
+    Tetromino toTetromino() const { return Tetromino(type, rotation, x, y); }
+};
+
+// Fixed-capacity result buffer so enumeration never allocates
+class PlacementList {
+public:
+    // Distinct placements are bounded by distinct shapes x anchor cells. On a high stack a piece
+    // can rest with its top cells in the rows above the board, so those count too.
+    static const int ROWS_ABOVE = 4;
+    static const int CAPACITY = TetrominoTables::ROTATIONS * Board::WIDTH * (ROWS_ABOVE + Board::HEIGHT);
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Placement& operator[](int index) const { return items[index]; }
+    const Placement* begin() const { return items; }
+    const Placement* end() const { return items + count; }
+
+    void clear() { count = 0; }
+    void push(const Placement& placement) {
+        assert(count < CAPACITY);
+        items[count++] = placement;
+    }
+
+private:
+    Placement items[CAPACITY];
+    int count = 0;
+};
+
+// Enumerates every distinct resting placement reachable from start using the moves
+// GameCore allows: left/right shifts, soft drops and clockwise rotation with its
+// right-then-left kick. Placements covering the same cells are reported once.
+// Works on bitboards a whole row of x positions at a time.
+void generatePlacements(const Board& board, const Tetromino& start, PlacementList& out);
+
+// Same, starting from the spawn position GameCore uses for a fresh piece of this type
+void generatePlacements(const Board& board, TetrominoType type, PlacementList& out);
+
+// Shortest input sequence that takes start to rest on the cells of target, ending with
+// the hard drop that locks it. Writes at most capacity inputs to out and returns the
+// sequence length, or -1 if target is unreachable (or the path doesn't fit). If positions
+// is not null, it gets the piece's position before each input, as many as there are inputs.
+int findInputPath(const Board& board, const Tetromino& start, const Placement& target, Input* out, int capacity, Tetromino* positions = nullptr);
+
+#endif // MOVEGENERATOR_H
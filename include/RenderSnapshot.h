@@ -0,0 +1,35 @@
+#ifndef RENDERSNAPSHOT_H
+#define RENDERSNAPSHOT_H
+
+#include "Board.h"
+#include "GameCore.h"
+#include "Tetromino.h"
+#include <cstdint>
+
+// Everything the frontend draws for one game, copied out of a GameCore so another thread can
+// draw it while the game moves on
+struct RenderSnapshot {
+    Board board;
+    uint64_t boardRevision = 0; // GameCore::getBoardRevision; the board layer redraws when it changes
+    Tetromino current;
+    Tetromino ghost; // Current piece at its landing spot
+    Tetromino next;
+    Tetromino held;
+    int score = 0;
+    int level = 1;
+    int pieces = 0;
+    uint64_t tick = 0;
+    bool paused = false;
+    bool gameOver = false;
+    bool playingBack = false;
+
+    // Running counts of sound events, so a reader that skips snapshots still hears every one
+    uint32_t moveSounds = 0;  // Player inputs the game accepted
+    uint32_t clearSounds = 0; // Locks that cleared lines
+
+    uint64_t simAllocations = 0; // Heap allocations made by the thread that published it (AllocTracker.h)
+
+    void capture(const GameCore& game); // Copies the game state; leaves the sound counts alone
+};
+
+#endif // RENDERSNAPSHOT_H
@@ -0,0 +1,124 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "GameCore.h"
+#include "MappedFile.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Binary replay: the seed plus every non-empty input with the tick it was applied on.
+// Replaying the inputs on a GameCore with the same seed reproduces the game exactly.
+//
+//   header:  "TTRP" | u8 version | u8 ticks per second | u16 reserved | u32 seed (little endian)
+//   input:   varint ticks since the previous record | u8 input mask
+//   trailer: varint ticks since the previous record | u8 END | varint score | varint pieces | varint lines
+//
+// Varints are LEB128. A file without a trailer is a session that was cut short.
+namespace ReplayFormat {
+const char MAGIC[4] = {'T', 'T', 'R', 'P'};
+const uint8_t VERSION = 1;
+const uint8_t END = 0x80; // Not a valid input mask (inputs use bits 0-6)
+const size_t HEADER_SIZE = 12;
+}
+
+// Final state claimed by a replay's trailer
+struct ReplaySummary {
+    uint64_t tick = 0;
+    int score = 0;
+    int pieces = 0;
+    int lines = 0;
+};
+
+// Encodes inputs on the caller's thread into a memory buffer and leaves the file I/O to a
+// background thread, so recording never blocks a frame.
+class ReplayWriter {
+public:
+    ReplayWriter();
+    ~ReplayWriter(); // Closes the file; a session not finished has no trailer
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    bool open(const std::string& path, uint32_t seed);
+    void record(uint64_t tick, Input input); // Input applied by the step starting at tick; None is skipped
+    void finish(const GameCore& game);       // Writes the trailer and closes the file
+    bool isOpen() const { return file != nullptr; }
+
+private:
+    std::FILE* file;
+    uint64_t lastTick;
+    std::vector<uint8_t> buffer; // Encoded but not yet written; guarded by mutex
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable dataReady;
+    bool stopping;
+
+    void append(const uint8_t* bytes, size_t count);
+    void writerLoop();
+    void close();
+};
+
+// Read-only view of a replay file, memory-mapped so playback decodes straight from the page cache
+class ReplayReader {
+public:
+    ReplayReader();
+
+    bool open(const std::string& path); // Reports a missing file or bad header on std::cerr
+    void close();
+
+    uint32_t getSeed() const { return seed; }
+    const uint8_t* begin() const { return file.data() + ReplayFormat::HEADER_SIZE; }
+    const uint8_t* end() const { return file.data() + file.size(); }
+
+private:
+    MappedFile file;
+    uint32_t seed;
+};
+
+// Feeds a replay's inputs into a game on the ticks they were recorded
+class ReplayPlayer {
+public:
+    explicit ReplayPlayer(const ReplayReader& reader);
+
+    void start(GameCore& game); // Resets the game to the replay's seed
+
+    // Steps the game until ticks more ticks have passed or the replay ends; false once it has ended
+    bool advance(GameCore& game, uint64_t ticks);
+    bool isFinished() const { return finished; }
+
+    bool isComplete() const { return complete; } // Replay ended with a trailer
+    const ReplaySummary& getSummary() const { return summary; } // Valid when complete
+    bool isCorrupt() const { return corrupt; }
+
+private:
+    const ReplayReader& reader;
+    const uint8_t* cursor;
+    uint64_t nextTick;  // Tick of the record at the cursor
+    uint8_t nextInput;
+    bool finished;
+    bool complete;
+    bool corrupt;
+    ReplaySummary summary;
+
+    void readRecord();
+};
+
+// Replays a whole file headless at full speed and checks the result against its trailer
+struct ReplayCheck {
+    bool loaded = false;
+    bool complete = false; // Had a trailer to check against
+    bool corrupt = false;  // Stopped at a record that could not be decoded
+    bool matches = false;  // Score, pieces, lines and length all reproduced
+    ReplaySummary recorded;
+    ReplaySummary replayed;
+};
+
+ReplayCheck verifyReplay(const std::string& path);
+
+#endif // REPLAY_H
@@ -0,0 +1,71 @@
+#ifndef SERVERPROTOCOL_H
+#define SERVERPROTOCOL_H
+
+#include "GameCore.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Binary protocol of tetromino_server. Every message is a frame:
+//
+//   u8 length of type and payload | u8 type | payload
+//
+// Client to server:
+//   NEW_GAME  u32 seed                        Starts (or restarts) the connection's game
+//   INPUT     u8 input mask | u16 ticks       Applies the input, then advances ticks ticks
+//
+// Server to client, in reply to each of those:
+//   UPDATE    u32 tick (low bits) | u8 flags | u8 piece type | u8 rotation | i8 x | i8 y
+//             | u8 next type | u8 held type
+//             | [u32 changed row mask | u16 row per set bit, top first]   if ROWS_CHANGED
+//             | [i32 score | u16 lines | u8 level]                        if SCORE_CHANGED
+//
+// Updates are deltas against what the connection was last sent: an input that only moves
+// the piece costs 13 bytes on the wire. Integers are little endian. The board is sent as
+// occupancy only; cell colors are cosmetic.
+namespace ServerProtocol {
+const uint8_t NEW_GAME = 1;
+const uint8_t INPUT = 2;
+const uint8_t UPDATE = 0x81;
+
+// UPDATE flags
+const uint8_t GAME_OVER = 1 << 0;
+const uint8_t PAUSED = 1 << 1;
+const uint8_t CAN_HOLD = 1 << 2;
+const uint8_t ROWS_CHANGED = 1 << 3;
+const uint8_t SCORE_CHANGED = 1 << 4;
+
+const size_t MAX_FRAME = 1 + 255; // Length byte plus the largest body
+}
+
+static_assert(Board::HEIGHT <= 32, "changed rows are sent as a 32-bit mask");
+
+// A game as a client sees it; the server keeps one per connection to encode deltas against
+struct SessionView {
+    uint32_t tick = 0;
+    uint8_t flags = 0;
+    TetrominoType piece = TetrominoType::None;
+    uint8_t rotation = 0;
+    int8_t x = 0;
+    int8_t y = 0;
+    TetrominoType next = TetrominoType::None;
+    TetrominoType held = TetrominoType::None;
+    Board::Row rows[Board::HEIGHT] = {};
+    int32_t score = -1; // Unknown until the first update, so that one always carries the score
+    uint16_t lines = 0;
+    uint8_t level = 0;
+
+    bool isGameOver() const { return (flags & ServerProtocol::GAME_OVER) != 0; }
+};
+
+namespace ServerProtocol {
+void encodeNewGame(std::vector<uint8_t>& out, uint32_t seed);
+void encodeInput(std::vector<uint8_t>& out, Input input, uint16_t ticks);
+
+// Appends an UPDATE frame for game and brings sent up to date with it
+void encodeUpdate(std::vector<uint8_t>& out, const GameCore& game, SessionView& sent);
+// Applies an UPDATE body (after the type byte) to view; false if it is malformed
+bool decodeUpdate(const uint8_t* body, size_t size, SessionView& view);
+}
+
+#endif // SERVERPROTOCOL_H
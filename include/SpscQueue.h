@@ -0,0 +1,47 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded queue from one producer thread to one consumer thread. Push and pop are wait-free:
+// each side only stores its own index and loads the other's.
+template <typename T, size_t capacity>
+class SpscQueue {
+public:
+    static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+    SpscQueue() : head(0), tail(0) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer; false if the queue is full
+    bool push(const T& value) {
+        size_t back = tail.load(std::memory_order_relaxed);
+        if (back - head.load(std::memory_order_acquire) == capacity) return false;
+        slots[back & (capacity - 1)] = value;
+        tail.store(back + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer; false if the queue is empty
+    bool pop(T& value) {
+        size_t front = head.load(std::memory_order_relaxed);
+        if (front == tail.load(std::memory_order_acquire)) return false;
+        value = slots[front & (capacity - 1)];
+        head.store(front + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer; the producer may push right after
+    bool empty() const { return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire); }
+
+private:
+    alignas(64) std::atomic<size_t> head; // Next slot to pop; written by the consumer
+    alignas(64) std::atomic<size_t> tail; // Next slot to push; written by the producer
+    std::array<T, capacity> slots;
+};
+
+#endif // SPSCQUEUE_H
@@ -1,33 +1,145 @@
 #ifndef TETROMINO_H
 #define TETROMINO_H
 
-#include <vector>
-#include <SDL.h>
+#include <array>
+#include <cstdint>
 
-enum class TetrominoType {
+enum class TetrominoType : uint8_t {
     I, O, T, S, Z, J, L, None
 };
 
+// RGBA color of a cell; kept SDL-free so the core builds headless
+struct Color {
+    uint8_t r, g, b, a;
+};
+
+// One orientation of a tetromino inside its size x size bounding box
+struct ShapeData {
+    uint8_t size;     // Side length of the rotation box (4 for I, 2 for O, 3 otherwise)
+    uint8_t rows[4];  // Occupancy mask per box row, bit x = box column x
+    int8_t cellX[4];  // Box coordinates of the occupied cells
+    int8_t cellY[4];
+    uint8_t cellCount;
+    int8_t minX, maxX, minY, maxY; // Tight bounding box of the occupied cells
+    int8_t bottomY[4]; // Lowest occupied box row per box column, -1 if the column is empty
+};
+
+namespace TetrominoTables {
+
+constexpr int TYPE_COUNT = static_cast<int>(TetrominoType::None) + 1;
+constexpr int ROTATIONS = 4;
+
+using ShapeTable = std::array<std::array<ShapeData, ROTATIONS>, TYPE_COUNT>;
+
+// Spawn orientation of each type as box row masks
+constexpr ShapeData baseShape(TetrominoType type) {
+    switch (type) {
+        case TetrominoType::I: return {4, {0b0000, 0b1111, 0b0000, 0b0000}, {}, {}, 0, 0, 0, 0, 0, {}};
+        case TetrominoType::O: return {2, {0b11, 0b11, 0, 0}, {}, {}, 0, 0, 0, 0, 0, {}};
+        case TetrominoType::T: return {3, {0b010, 0b111, 0b000, 0}, {}, {}, 0, 0, 0, 0, 0, {}};
+        case TetrominoType::S: return {3, {0b110, 0b011, 0b000, 0}, {}, {}, 0, 0, 0, 0, 0, {}};
+        case TetrominoType::Z: return {3, {0b011, 0b110, 0b000, 0}, {}, {}, 0, 0, 0, 0, 0, {}};
+        case TetrominoType::J: return {3, {0b001, 0b111, 0b000, 0}, {}, {}, 0, 0, 0, 0, 0, {}};
+        case TetrominoType::L: return {3, {0b100, 0b111, 0b000, 0}, {}, {}, 0, 0, 0, 0, 0, {}};
+        case TetrominoType::None: break;
+    }
+    return {0, {0, 0, 0, 0}, {}, {}, 0, 0, 0, 0, 0, {}};
+}
+
+// Rotate clockwise within the box: cell (row i, col j) moves to (row j, col size - 1 - i)
+constexpr ShapeData rotateClockwise(const ShapeData& shape) {
+    ShapeData rotated = {shape.size, {0, 0, 0, 0}, {}, {}, 0, 0, 0, 0, 0, {}};
+    for (int i = 0; i < shape.size; ++i) {
+        for (int j = 0; j < shape.size; ++j) {
+            if ((shape.rows[i] >> j) & 1) {
+                rotated.rows[j] |= static_cast<uint8_t>(1u << (shape.size - 1 - i));
+            }
+        }
+    }
+    return rotated;
+}
+
+// Fill in the cell list and bounding box from the row masks
+constexpr ShapeData withCells(ShapeData shape) {
+    shape.cellCount = 0;
+    shape.minX = shape.minY = 4;
+    shape.maxX = shape.maxY = -1;
+    for (int x = 0; x < 4; ++x) {
+        shape.bottomY[x] = -1;
+    }
+    for (int y = 0; y < shape.size; ++y) {
+        for (int x = 0; x < shape.size; ++x) {
+            if ((shape.rows[y] >> x) & 1) {
+                shape.cellX[shape.cellCount] = static_cast<int8_t>(x);
+                shape.cellY[shape.cellCount] = static_cast<int8_t>(y);
+                shape.cellCount++;
+                if (x < shape.minX) shape.minX = static_cast<int8_t>(x);
+                if (x > shape.maxX) shape.maxX = static_cast<int8_t>(x);
+                if (y < shape.minY) shape.minY = static_cast<int8_t>(y);
+                if (y > shape.maxY) shape.maxY = static_cast<int8_t>(y);
+                shape.bottomY[x] = static_cast<int8_t>(y); // Rows are scanned top to bottom
+            }
+        }
+    }
+    if (shape.cellCount == 0) {
+        shape.minX = shape.minY = 0;
+    }
+    return shape;
+}
+
+constexpr ShapeTable buildShapeTable() {
+    ShapeTable table = {};
+    for (int type = 0; type < TYPE_COUNT; ++type) {
+        ShapeData shape = baseShape(static_cast<TetrominoType>(type));
+        for (int rotation = 0; rotation < ROTATIONS; ++rotation) {
+            table[type][rotation] = withCells(shape);
+            if (static_cast<TetrominoType>(type) != TetrominoType::O) { // O block doesn't rotate
+                shape = rotateClockwise(shape);
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr ShapeTable SHAPES = buildShapeTable();
+
+inline constexpr Color COLORS[TYPE_COUNT] = {
+    {0, 255, 255, 255}, // I: Cyan
+    {255, 255, 0, 255}, // O: Yellow
+    {128, 0, 128, 255}, // T: Purple
+    {0, 255, 0, 255},   // S: Green
+    {255, 0, 0, 255},   // Z: Red
+    {0, 0, 255, 255},   // J: Blue
+    {255, 165, 0, 255}, // L: Orange
+    {0, 0, 0, 0}        // None
+};
+
+} // namespace TetrominoTables
+
+// A falling piece as a plain value: type, rotation index and position.
+// Shapes come from the precomputed tables, so copying, moving and rotating never allocate.
 class Tetromino {
 public:
-    Tetromino(TetrominoType type = TetrominoType::None);
+    constexpr Tetromino(TetrominoType type = TetrominoType::None)
+        : type(type), rotation(0), x(type == TetrominoType::O ? 4 : (type == TetrominoType::None ? 0 : 3)), y(0) {}
+    constexpr Tetromino(TetrominoType type, int rotation, int x, int y)
+        : type(type), rotation(static_cast<uint8_t>(rotation & (TetrominoTables::ROTATIONS - 1))), x(x), y(y) {}
 
-    void rotate();
-    void move(int dx, int dy);
+    void rotate() { rotation = (rotation + 1) & (TetrominoTables::ROTATIONS - 1); }
+    void move(int dx, int dy) { x += dx; y += dy; }
 
-    const std::vector<std::vector<int>>& getShape() const { return shape; }
-    SDL_Color getColor() const { return color; }
+    const ShapeData& getShape() const { return TetrominoTables::SHAPES[static_cast<int>(type)][rotation]; }
+    int getSize() const { return getShape().size; }
+    Color getColor() const { return TetrominoTables::COLORS[static_cast<int>(type)]; }
     int getX() const { return x; }
     int getY() const { return y; }
+    int getRotation() const { return rotation; }
     TetrominoType getType() const { return type; }
 
 private:
     TetrominoType type;
-    std::vector<std::vector<int>> shape;
-    SDL_Color color;
+    uint8_t rotation;
     int x, y; // Position on the game board
-
-    void setShapeAndColor(TetrominoType type);
 };
 
 #endif // TETROMINO_H
@@ -0,0 +1,56 @@
+#ifndef TEXTRENDERER_H
+#define TEXTRENDERER_H
+
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+// Caches HUD text on the GPU so nothing is rasterized or uploaded per frame:
+// static labels are rendered to a texture once, and changing text (scores) is
+// drawn glyph by glyph from a single atlas texture tinted with a color mod.
+class TextRenderer {
+public:
+    TextRenderer();
+    ~TextRenderer();
+
+    void setFont(TTF_Font* font); // Drops all cached textures
+
+    // Whole string rendered once and reused; for fixed strings like "Score:" or "PAUSED"
+    void drawLabel(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color);
+    // Drawn from the glyph atlas; for text that changes from frame to frame
+    void drawText(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color);
+    void drawNumber(SDL_Renderer* renderer, int value, int x, int y, SDL_Color color);
+
+    int labelWidth(SDL_Renderer* renderer, const char* text, SDL_Color color); // Width of a cached label in pixels
+
+private:
+    static const int FIRST_GLYPH = 32; // Atlas covers printable ASCII
+    static const int LAST_GLYPH = 126;
+    static const int ATLAS_WIDTH = 512;
+
+    struct Glyph {
+        SDL_Rect source; // Location in the atlas
+        int advance;
+    };
+
+    struct Label {
+        std::string text;
+        SDL_Color color;
+        SDL_Texture* texture;
+        int width, height;
+    };
+
+    TTF_Font* font;
+    SDL_Renderer* owner; // Renderer the cached textures belong to
+    SDL_Texture* atlas;
+    Glyph glyphs[LAST_GLYPH - FIRST_GLYPH + 1];
+    std::vector<Label> labels;
+
+    bool prepare(SDL_Renderer* renderer); // (Re)builds the atlas for this renderer if needed
+    bool buildAtlas();
+    const Label* findLabel(const char* text, SDL_Color color);
+    void clear();
+};
+
+#endif // TEXTRENDERER_H
@@ -0,0 +1,36 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed-size cache from 64-bit position hashes (Zobrist.h) to 64-bit values, shared by any
+// number of search threads without locks. Each slot stores the value and the key XORed with
+// it; a slot torn by two threads writing at once fails that check and reads as a miss, so a
+// probe never returns another position's value. Stores always replace.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes); // Rounded down to a power of two slots, at least one
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    bool probe(uint64_t key, uint64_t& value) const;
+    void store(uint64_t key, uint64_t value);
+    void clear(); // Not safe while other threads use the table
+
+    size_t getSlotCount() const { return mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check; // key ^ value; zero-filled slots only match key 0
+        std::atomic<uint64_t> value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+};
+
+#endif // TRANSPOSITIONTABLE_H
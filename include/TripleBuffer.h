@@ -0,0 +1,52 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value from one writer thread to one reader thread without locks or waiting.
+// The writer fills the back buffer and publishes it; the reader picks up the newest published
+// buffer, skipping any it was too slow to see. Neither side ever blocks the other: they only
+// exchange buffer indices through one atomic.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), backIndex(2), frontIndex(0) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer: the buffer to fill next; it holds an old value, so every field must be written
+    T& back() { return buffers[backIndex]; }
+
+    // Writer: makes the back buffer the newest value and takes over the one it replaces
+    void publish() {
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(backIndex | FRESH), std::memory_order_acq_rel);
+        backIndex = previous & INDEX_MASK;
+    }
+
+    // Reader: makes the newest published value current; false if nothing was published since
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    // Reader: the current value; stays put until the next acquire
+    const T& front() const { return buffers[frontIndex]; }
+
+    // Either side: a published value is waiting for the reader
+    bool hasUnread() const { return middle.load(std::memory_order_acquire) & FRESH; }
+
+private:
+    static const uint8_t INDEX_MASK = 3;
+    static const uint8_t FRESH = 4; // Set in middle when it holds a value the reader hasn't taken
+
+    T buffers[3];
+    std::atomic<uint8_t> middle; // Index of the buffer between the two sides, plus FRESH
+    uint8_t backIndex;           // Writer's
+    uint8_t frontIndex;          // Reader's
+};
+
+#endif // TRIPLEBUFFER_H
@@ -0,0 +1,31 @@
+#ifndef VIDEOEXPORTER_H
+#define VIDEOEXPORTER_H
+
+#include <cstdint>
+#include <string>
+
+struct ExportOptions {
+    int width = 1280;
+    int height = 720;
+    int cellSize = 0;           // 0 = fit the board like the window does
+    uint32_t ticksPerFrame = 1; // Game ticks per video frame; the frame rate is 60 / ticksPerFrame
+    uint64_t startTick = 0;     // Skipped headless before the first frame
+    uint64_t maxFrames = 0;     // 0 = until the replay ends
+    unsigned threads = 0;       // Rasterizer threads; 0 = one per hardware core
+};
+
+struct ExportResult {
+    bool ok = false;
+    uint64_t frames = 0; // Frames written
+    uint64_t drawn = 0;  // Frames rasterized; the rest repeat the frame before them
+    uint64_t ticks = 0;  // Game ticks the video covers
+};
+
+// Renders a replay to an uncompressed YUV4MPEG2 (.y4m) video without a window or GPU.
+// The replay is simulated on the calling thread, frames are rasterized and converted to
+// YUV on worker threads, and a writer thread streams them to the file in order, so all three
+// stages overlap. Frames that look the same as the one before are written again without
+// being drawn. outputPath "-" writes to stdout, e.g. to pipe into ffmpeg.
+ExportResult exportReplay(const std::string& replayPath, const std::string& outputPath, const ExportOptions& options);
+
+#endif // VIDEOEXPORTER_H
@@ -0,0 +1,67 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads, each with its own job deque.
+// Workers pop their own jobs LIFO and steal FIFO from the others when they run dry.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threadCount = 0); // 0 = one thread per hardware core
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> job); // Distributed round-robin over the worker deques
+    void wait();                            // Blocks until every submitted job has finished
+
+    // Calls fn(0) .. fn(count - 1) on the workers and the calling thread and returns when all
+    // are done. Unlike submit it allocates nothing, so it suits loops run every step; fn must
+    // outlive the call. One caller at a time.
+    void run(int count, const std::function<void(int)>& fn);
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(threads.size()); }
+    size_t getStealCount() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> jobs;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex idleMutex;
+    std::condition_variable workAvailable; // Signalled when jobs are queued or on shutdown
+    std::condition_variable allDone;       // Signalled when the last pending job finishes
+    std::atomic<size_t> queued;            // Jobs sitting in a deque
+    std::atomic<size_t> pending;           // Jobs submitted but not yet finished
+    std::atomic<size_t> steals;
+    std::atomic<unsigned> nextQueue;
+    bool stopping;
+
+    // Current run(): item count in the high 32 bits, next unclaimed item in the low 32, so one
+    // fetch_add claims an item and sees the count it belongs to
+    std::atomic<uint64_t> batchState;
+    std::atomic<int> batchLeft; // Items not yet finished
+    const std::function<void(int)>* batchFn;
+
+    bool popLocal(unsigned index, std::function<void()>& job);
+    bool steal(unsigned index, std::function<void()>& job);
+    bool runBatch(); // Runs run() items until none are left unclaimed; false if there were none
+    bool batchWaiting() const;
+    void workerLoop(unsigned index);
+};
+
+#endif // WORKSTEALINGPOOL_H
@@ -0,0 +1,105 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Tetromino.h"
+#include <array>
+#include <cstdint>
+
+// Zobrist keys for hashing positions: a board hashes to the XOR of the keys of its filled
+// cells, and a piece to the XOR of keys for its type and rotation, column and row. Keys are
+// fixed at compile time, so hashes are stable across runs and threads.
+namespace Zobrist {
+
+constexpr uint64_t splitMix(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Cell keys of a board with width columns and rowCount stored rows. Rows are hashed in at most
+// eight-column chunks, each with a table of the XOR of the cell keys for every chunk pattern,
+// so a whole row costs one lookup per chunk (two on a 10-wide board).
+template <int width, int rowCount>
+struct BoardKeys {
+    static constexpr int CHUNKS = (width + 7) / 8;
+    static constexpr int CHUNK_BITS = (width + CHUNKS - 1) / CHUNKS;
+
+    uint64_t emptyBoard; // Hash of the empty board; nonzero so no real board hashes to an empty table slot
+    std::array<std::array<std::array<uint64_t, 1 << CHUNK_BITS>, CHUNKS>, rowCount> chunks;
+
+    // Key of the cells set in row at stored row index
+    uint64_t row(int index, uint64_t row) const {
+        uint64_t key = 0;
+        for (int chunk = 0; chunk < CHUNKS; ++chunk) {
+            key ^= chunks[index][chunk][(row >> (chunk * CHUNK_BITS)) & ((1u << CHUNK_BITS) - 1)];
+        }
+        return key;
+    }
+};
+
+template <int width, int rowCount>
+constexpr BoardKeys<width, rowCount> makeBoardKeys() {
+    using Keys = BoardKeys<width, rowCount>;
+    Keys keys = {};
+    uint64_t state = 0x7E7201D0ull ^ (static_cast<uint64_t>(width) << 32 | static_cast<uint64_t>(rowCount));
+    keys.emptyBoard = splitMix(state);
+    for (int y = 0; y < rowCount; ++y) {
+        uint64_t cells[Keys::CHUNKS * Keys::CHUNK_BITS] = {};
+        for (int x = 0; x < width; ++x) {
+            cells[x] = splitMix(state); // Padding columns past the width keep key 0
+        }
+        for (int chunk = 0; chunk < Keys::CHUNKS; ++chunk) {
+            auto& table = keys.chunks[y][chunk];
+            for (int bits = 1; bits < (1 << Keys::CHUNK_BITS); ++bits) {
+                int lowest = 0;
+                while (!(bits & (1 << lowest))) ++lowest;
+                table[bits] = table[bits & (bits - 1)] ^ cells[chunk * Keys::CHUNK_BITS + lowest]; // Add the lowest set column
+            }
+        }
+    }
+    return keys;
+}
+
+template <int width, int rowCount>
+inline constexpr BoardKeys<width, rowCount> BOARD_KEYS = makeBoardKeys<width, rowCount>();
+
+const int PIECE_OFFSET = 4;        // Piece boxes may hang this far outside the board
+const int MAX_PIECE_COLUMNS = 64;  // Widest board the piece keys cover
+const int MAX_PIECE_ROWS = 128;    // Stored rows, hidden ones included, the piece keys cover
+
+struct PieceKeys {
+    std::array<std::array<uint64_t, TetrominoTables::ROTATIONS>, TetrominoTables::TYPE_COUNT> shape;
+    std::array<uint64_t, MAX_PIECE_COLUMNS + 2 * PIECE_OFFSET> x;
+    std::array<uint64_t, 2 * MAX_PIECE_ROWS> y; // Index y + MAX_PIECE_ROWS, so hidden rows above 0 fit
+    std::array<uint64_t, TetrominoTables::TYPE_COUNT> held;
+};
+
+constexpr PieceKeys makePieceKeys() {
+    PieceKeys keys = {};
+    uint64_t state = 0x9D1ECE5ull;
+    for (auto& rotations : keys.shape) {
+        for (uint64_t& key : rotations) key = splitMix(state);
+    }
+    for (uint64_t& key : keys.x) key = splitMix(state);
+    for (uint64_t& key : keys.y) key = splitMix(state);
+    for (uint64_t& key : keys.held) key = splitMix(state);
+    return keys;
+}
+
+inline constexpr PieceKeys PIECE_KEYS = makePieceKeys();
+
+// Key of a piece in play; XOR it with the board's getHash for the whole position
+inline uint64_t pieceKey(const Tetromino& tetromino) {
+    return PIECE_KEYS.shape[static_cast<int>(tetromino.getType())][tetromino.getRotation()]
+         ^ PIECE_KEYS.x[tetromino.getX() + PIECE_OFFSET] ^ PIECE_KEYS.y[tetromino.getY() + MAX_PIECE_ROWS];
+}
+
+// Key of the piece in the hold slot (None included)
+inline uint64_t heldKey(const Tetromino& tetromino) {
+    return PIECE_KEYS.held[static_cast<int>(tetromino.getType())];
+}
+
+}
+
+#endif // ZOBRIST_H
@@ -0,0 +1,70 @@
+#ifndef TETROMINO_ENV_H
+#define TETROMINO_ENV_H
+
+/* C API for stepping many games at once, for reinforcement learning. Observations are
+ * written into caller-owned structure-of-arrays buffers bound once with
+ * tetromino_env_set_buffers; stepping allocates nothing and returns nothing by copy.
+ * A game that ends is reset at once with a fresh seed: its done flag is set and its
+ * observation is the first of the new game. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define TETROMINO_ENV_API __declspec(dllexport)
+#else
+#define TETROMINO_ENV_API __attribute__((visibility("default")))
+#endif
+
+#define TETROMINO_BOARD_WIDTH 10
+#define TETROMINO_BOARD_HEIGHT 20
+
+/* Action bits; combine any of them for one step */
+#define TETROMINO_INPUT_LEFT 0x01
+#define TETROMINO_INPUT_RIGHT 0x02
+#define TETROMINO_INPUT_SOFT_DROP 0x04
+#define TETROMINO_INPUT_ROTATE 0x08
+#define TETROMINO_INPUT_HARD_DROP 0x10
+#define TETROMINO_INPUT_HOLD 0x20
+
+/* Piece types: I, O, T, S, Z, J, L are 0-6 */
+#define TETROMINO_PIECE_NONE 7
+
+/* Element i of every array belongs to game i. Any pointer may be null to skip that field. */
+typedef struct TetrominoEnvBuffers {
+    uint8_t* occupancy;     /* count * HEIGHT * WIDTH, row-major per game, top row first; 1 = locked cell */
+    int8_t* piece_type;     /* Falling piece */
+    int8_t* piece_rotation;
+    int8_t* piece_x;        /* Top left of the piece's rotation box, in cells */
+    int8_t* piece_y;
+    int8_t* next_type;
+    int8_t* held_type;      /* TETROMINO_PIECE_NONE until something is held */
+    int32_t* score;
+    int32_t* level;
+    float* reward;          /* Score gained by the last step */
+    uint8_t* done;          /* The last step ended the game (and reset it) */
+} TetrominoEnvBuffers;
+
+typedef struct TetrominoEnv TetrominoEnv;
+
+/* count games seeded from seed, already reset. threads > 1 steps slices of the games in parallel.
+ * ticks_per_step is the game time one step advances; 0 turns gravity off. Null on bad arguments. */
+TETROMINO_ENV_API TetrominoEnv* tetromino_env_create(int count, uint32_t seed, int threads, uint32_t ticks_per_step);
+TETROMINO_ENV_API void tetromino_env_destroy(TetrominoEnv* env);
+
+TETROMINO_ENV_API int tetromino_env_count(const TetrominoEnv* env);
+TETROMINO_ENV_API void tetromino_env_set_buffers(TetrominoEnv* env, const TetrominoEnvBuffers* buffers);
+
+/* Restarts every game and writes the first observations; reward and done are cleared */
+TETROMINO_ENV_API void tetromino_env_reset(TetrominoEnv* env);
+/* Applies actions[i] (TETROMINO_INPUT_* bits) to game i, then writes the observations */
+TETROMINO_ENV_API void tetromino_env_step(TetrominoEnv* env, const uint8_t* actions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TETROMINO_ENV_H */
@@ -0,0 +1,121 @@
+"""Thin ctypes binding over the tetromino_env C API (include/tetromino_env.h).
+
+    env = VecEnv(count=1024, seed=1, threads=4)
+    obs = env.reset()
+    obs, reward, done = env.step(actions)  # actions: uint8 array of TETROMINO_INPUT_* bits
+
+Observations live in numpy arrays owned by the VecEnv and are overwritten in place by every
+step: copy anything you need to keep. The shared library is found through TETROMINO_ENV_LIB,
+next to this file, or in ../build and ../_build.
+"""
+
+import ctypes
+import os
+
+import numpy as np
+
+BOARD_WIDTH = 10
+BOARD_HEIGHT = 20
+
+INPUT_LEFT = 0x01
+INPUT_RIGHT = 0x02
+INPUT_SOFT_DROP = 0x04
+INPUT_ROTATE = 0x08
+INPUT_HARD_DROP = 0x10
+INPUT_HOLD = 0x20
+
+PIECE_NONE = 7
+
+
+class _Buffers(ctypes.Structure):
+    _fields_ = [
+        ("occupancy", ctypes.c_void_p),
+        ("piece_type", ctypes.c_void_p),
+        ("piece_rotation", ctypes.c_void_p),
+        ("piece_x", ctypes.c_void_p),
+        ("piece_y", ctypes.c_void_p),
+        ("next_type", ctypes.c_void_p),
+        ("held_type", ctypes.c_void_p),
+        ("score", ctypes.c_void_p),
+        ("level", ctypes.c_void_p),
+        ("reward", ctypes.c_void_p),
+        ("done", ctypes.c_void_p),
+    ]
+
+
+def _library_names():
+    if os.name == "nt":
+        return ["tetromino_env.dll"]
+    if os.uname().sysname == "Darwin":
+        return ["libtetromino_env.dylib"]
+    return ["libtetromino_env.so"]
+
+
+def _load_library():
+    explicit = os.environ.get("TETROMINO_ENV_LIB")
+    if explicit:
+        return ctypes.CDLL(explicit)
+    here = os.path.dirname(os.path.abspath(__file__))
+    for directory in (here, os.path.join(here, "..", "build"), os.path.join(here, "..", "_build")):
+        for name in _library_names():
+            path = os.path.join(directory, name)
+            if os.path.exists(path):
+                return ctypes.CDLL(path)
+    raise OSError("tetromino_env library not found; build it or set TETROMINO_ENV_LIB")
+
+
+_lib = _load_library()
+_lib.tetromino_env_create.restype = ctypes.c_void_p
+_lib.tetromino_env_create.argtypes = [ctypes.c_int, ctypes.c_uint32, ctypes.c_int, ctypes.c_uint32]
+_lib.tetromino_env_destroy.argtypes = [ctypes.c_void_p]
+_lib.tetromino_env_count.argtypes = [ctypes.c_void_p]
+_lib.tetromino_env_set_buffers.argtypes = [ctypes.c_void_p, ctypes.POINTER(_Buffers)]
+_lib.tetromino_env_reset.argtypes = [ctypes.c_void_p]
+_lib.tetromino_env_step.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+
+
+class VecEnv:
+    """count games stepped together; finished games reset automatically."""
+
+    def __init__(self, count, seed=0, threads=1, ticks_per_step=1):
+        self._env = _lib.tetromino_env_create(count, seed, threads, ticks_per_step)
+        if not self._env:
+            raise ValueError("tetromino_env_create failed")
+        self.count = count
+        self.observation = {
+            "occupancy": np.zeros((count, BOARD_HEIGHT, BOARD_WIDTH), dtype=np.uint8),
+            "piece_type": np.zeros(count, dtype=np.int8),
+            "piece_rotation": np.zeros(count, dtype=np.int8),
+            "piece_x": np.zeros(count, dtype=np.int8),
+            "piece_y": np.zeros(count, dtype=np.int8),
+            "next_type": np.zeros(count, dtype=np.int8),
+            "held_type": np.zeros(count, dtype=np.int8),
+            "score": np.zeros(count, dtype=np.int32),
+            "level": np.zeros(count, dtype=np.int32),
+        }
+        self.reward = np.zeros(count, dtype=np.float32)
+        self.done = np.zeros(count, dtype=np.uint8)
+
+        # The library keeps these pointers; the arrays live as long as this object
+        arrays = dict(self.observation, reward=self.reward, done=self.done)
+        buffers = _Buffers(**{name: array.ctypes.data for name, array in arrays.items()})
+        _lib.tetromino_env_set_buffers(self._env, ctypes.byref(buffers))
+
+    def reset(self):
+        _lib.tetromino_env_reset(self._env)
+        return self.observation
+
+    def step(self, actions):
+        actions = np.ascontiguousarray(actions, dtype=np.uint8)
+        if actions.shape != (self.count,):
+            raise ValueError("expected %d actions, got shape %s" % (self.count, actions.shape))
+        _lib.tetromino_env_step(self._env, actions.ctypes.data)
+        return self.observation, self.reward, self.done
+
+    def close(self):
+        if self._env:
+            _lib.tetromino_env_destroy(self._env)
+            self._env = None
+
+    def __del__(self):
+        self.close()
@@ -0,0 +1,29 @@
+#include "AllocTracker.h"
+#include <atomic>
+
+namespace {
+std::atomic<bool> enabled(false);
+std::atomic<uint64_t> allocations(0);
+thread_local uint64_t threadAllocations = 0;
+}
+
+bool AllocTracker::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocTracker::total() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocTracker::thisThread() {
+    return threadAllocations;
+}
+
+void AllocTracker::enable() {
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+void AllocTracker::count() {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    ++threadAllocations;
+}
@@ -0,0 +1,109 @@
+#include "AssetLoader.h"
+#include <iostream>
+
+static const int FONT_SIZE = 24;
+
+static void reportMissing(const char* what, bool fromMixer) {
+    std::cerr << "Failed to load " << what << "! " << (fromMixer ? "SDL_mixer" : "SDL_ttf")
+              << " Error: " << (fromMixer ? Mix_GetError() : TTF_GetError()) << std::endl;
+}
+
+AssetLoader::AssetLoader() : ready(false) {}
+
+AssetLoader::~AssetLoader() {
+    if (worker.joinable()) worker.join();
+    if (assets.font) TTF_CloseFont(assets.font);
+    if (assets.music) Mix_FreeMusic(assets.music);
+    if (assets.moveSound) Mix_FreeChunk(assets.moveSound);
+    if (assets.scoreSound) Mix_FreeChunk(assets.scoreSound);
+    if (assets.gameOverSound) Mix_FreeChunk(assets.gameOverSound);
+}
+
+void AssetLoader::start(const std::string& packPath) {
+    requestedPack = packPath;
+    ready = false;
+    worker = std::thread(&AssetLoader::load, this);
+}
+
+GameAssets AssetLoader::take() {
+    if (worker.joinable()) worker.join();
+    GameAssets taken = assets;
+    assets = GameAssets();
+    return taken;
+}
+
+void AssetLoader::load() {
+    if (openPack()) {
+        loadFromPack();
+    } else {
+        loadLooseFiles();
+    }
+    ready.store(true, std::memory_order_release);
+
+    // Wake the main loop in case it is blocked waiting for input
+    SDL_Event event = {};
+    event.type = SDL_USEREVENT;
+    SDL_PushEvent(&event);
+}
+
+bool AssetLoader::openPack() {
+    if (!requestedPack.empty()) {
+        if (pack.open(requestedPack)) return true;
+        std::cerr << "Unable to open asset pack " << requestedPack << "; loading loose files" << std::endl;
+        return false;
+    }
+
+    char* basePath = SDL_GetBasePath();
+    if (basePath) {
+        bool opened = pack.open(std::string(basePath) + "assets.pak");
+        SDL_free(basePath);
+        if (opened) return true;
+    }
+    return pack.open("assets.pak");
+}
+
+void AssetLoader::loadFromPack() {
+    // Everything is read in place from the mapping: no file I/O and, for the pre-decoded
+    // sound effects, no decoding either
+    auto open = [this](const char* name) -> SDL_RWops* {
+        AssetData data = pack.find(name);
+        return data ? SDL_RWFromConstMem(data.data, static_cast<int>(data.size)) : nullptr;
+    };
+
+    SDL_RWops* source = open("font");
+    assets.font = source ? TTF_OpenFontRW(source, 1, FONT_SIZE) : nullptr;
+    if (assets.font == nullptr) reportMissing("font", false);
+
+    source = open("music"); // Kept compressed and streamed while playing
+    assets.music = source ? Mix_LoadMUS_RW(source, 1) : nullptr;
+    if (assets.music == nullptr) reportMissing("background music", true);
+
+    source = open("move");
+    assets.moveSound = source ? Mix_LoadWAV_RW(source, 1) : nullptr;
+    if (assets.moveSound == nullptr) reportMissing("move sound", true);
+
+    source = open("score");
+    assets.scoreSound = source ? Mix_LoadWAV_RW(source, 1) : nullptr;
+    if (assets.scoreSound == nullptr) reportMissing("score sound", true);
+
+    source = open("gameover");
+    assets.gameOverSound = source ? Mix_LoadWAV_RW(source, 1) : nullptr;
+    if (assets.gameOverSound == nullptr) reportMissing("game over sound", true);
+}
+
+void AssetLoader::loadLooseFiles() {
+    assets.font = TTF_OpenFont("build/Array-Regular.otf", FONT_SIZE);
+    if (assets.font == nullptr) reportMissing("font", false);
+
+    assets.music = Mix_LoadMUS("assets/sounds/tetris-theme.mp3");
+    if (assets.music == nullptr) reportMissing("background music", true);
+
+    assets.moveSound = Mix_LoadWAV("assets/sounds/blip-131856.mp3");
+    if (assets.moveSound == nullptr) reportMissing("move sound", true);
+
+    assets.scoreSound = Mix_LoadWAV("assets/sounds/nintendo-game-boy-startup.mp3");
+    if (assets.scoreSound == nullptr) reportMissing("score sound", true);
+
+    assets.gameOverSound = Mix_LoadWAV("assets/sounds/game-over-classic-206486.mp3");
+    if (assets.gameOverSound == nullptr) reportMissing("game over sound", true);
+}
@@ -0,0 +1,121 @@
+#include "AssetPack.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+static uint64_t readLittleEndian(const uint8_t* bytes, int count) {
+    uint64_t value = 0;
+    for (int i = 0; i < count; ++i) {
+        value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+static void writeLittleEndian(std::vector<uint8_t>& out, uint64_t value, int count) {
+    for (int i = 0; i < count; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+
+    const uint8_t* data = file.data();
+    size_t size = file.size();
+    if (size < 16 || std::memcmp(data, AssetPackFormat::MAGIC, sizeof(AssetPackFormat::MAGIC)) != 0
+        || readLittleEndian(data + 4, 4) != AssetPackFormat::VERSION) {
+        std::cerr << "Not a supported asset pack: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // Read the table, checking every entry stays inside the file
+    uint32_t count = static_cast<uint32_t>(readLittleEndian(data + 8, 4));
+    size_t position = 16;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (position + 4 > size) break;
+        size_t nameLength = static_cast<size_t>(readLittleEndian(data + position, 4));
+        position += 4;
+        if (nameLength > size - position || size - position - nameLength < 16) break;
+
+        Entry entry;
+        entry.name.assign(reinterpret_cast<const char*>(data + position), nameLength);
+        position += nameLength;
+        entry.offset = readLittleEndian(data + position, 8);
+        entry.size = readLittleEndian(data + position + 8, 8);
+        position += 16;
+        if (entry.offset > size || entry.size > size - entry.offset) break;
+        entries.push_back(entry);
+    }
+    if (entries.size() != count) {
+        std::cerr << "Asset pack is truncated or corrupt: " << path << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AssetPack::close() {
+    entries.clear();
+    file.close();
+}
+
+AssetData AssetPack::find(const std::string& name) const {
+    AssetData asset;
+    for (const Entry& entry : entries) { // A handful of assets; no index needed
+        if (entry.name == name) {
+            asset.data = file.data() + entry.offset;
+            asset.size = static_cast<size_t>(entry.size);
+            break;
+        }
+    }
+    return asset;
+}
+
+void AssetPackWriter::add(const std::string& name, std::vector<uint8_t> bytes) {
+    assets.push_back({name, std::move(bytes)});
+}
+
+bool AssetPackWriter::write(const std::string& path) const {
+    auto align = [](size_t offset) { return (offset + AssetPackFormat::ALIGNMENT - 1) / AssetPackFormat::ALIGNMENT * AssetPackFormat::ALIGNMENT; };
+
+    size_t tableSize = 0;
+    for (const Asset& asset : assets) {
+        tableSize += 4 + asset.name.size() + 16;
+    }
+
+    std::vector<uint8_t> header(AssetPackFormat::MAGIC, AssetPackFormat::MAGIC + sizeof(AssetPackFormat::MAGIC));
+    writeLittleEndian(header, AssetPackFormat::VERSION, 4);
+    writeLittleEndian(header, assets.size(), 4);
+    writeLittleEndian(header, 0, 4);
+
+    size_t offset = align(16 + tableSize);
+    for (const Asset& asset : assets) {
+        writeLittleEndian(header, asset.name.size(), 4);
+        header.insert(header.end(), asset.name.begin(), asset.name.end());
+        writeLittleEndian(header, offset, 8);
+        writeLittleEndian(header, asset.bytes.size(), 8);
+        offset = align(offset + asset.bytes.size());
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Unable to write asset pack " << path << std::endl;
+        return false;
+    }
+    static const uint8_t padding[AssetPackFormat::ALIGNMENT] = {};
+    bool ok = std::fwrite(header.data(), 1, header.size(), file) == header.size();
+    size_t written = header.size();
+    for (const Asset& asset : assets) {
+        ok = ok && std::fwrite(padding, 1, align(written) - written, file) == align(written) - written;
+        written = align(written);
+        ok = ok && std::fwrite(asset.bytes.data(), 1, asset.bytes.size(), file) == asset.bytes.size();
+        written += asset.bytes.size();
+    }
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error while writing asset pack " << path << std::endl;
+    }
+    return ok;
+}
@@ -0,0 +1,94 @@
+#include "BatchEnv.h"
+#include <array>
+#include <cstring>
+
+// Cells of every possible row, so a row is written with one copy instead of a loop over its bits
+static std::array<std::array<uint8_t, Board::WIDTH>, 1 << Board::WIDTH> buildRowCells() {
+    std::array<std::array<uint8_t, Board::WIDTH>, 1 << Board::WIDTH> table = {};
+    for (int row = 0; row < (1 << Board::WIDTH); ++row) {
+        for (int x = 0; x < Board::WIDTH; ++x) {
+            table[row][x] = static_cast<uint8_t>((row >> x) & 1);
+        }
+    }
+    return table;
+}
+
+static const std::array<std::array<uint8_t, Board::WIDTH>, 1 << Board::WIDTH> ROW_CELLS = buildRowCells();
+
+// Inputs an agent may send; pausing would only stall its own game
+static const uint8_t ACTION_MASK = static_cast<uint8_t>(Input::Left | Input::Right | Input::SoftDrop | Input::Rotate | Input::HardDrop | Input::Hold);
+
+BatchEnv::BatchEnv(int count, uint32_t seed, unsigned threads, uint32_t ticksPerStep)
+    : games(count), episodes(count, 0), buffers(), seed(seed), ticksPerStep(ticksPerStep), sliceCount(1), stepActions(nullptr) {
+    if (threads > 1 && count > 1) {
+        pool.reset(new WorkStealingPool(threads));
+        sliceCount = static_cast<int>(std::min<unsigned>(threads, static_cast<unsigned>(count)));
+        stepSlice = [this](int slice) {
+            int first = static_cast<int>(static_cast<int64_t>(getCount()) * slice / sliceCount);
+            int last = static_cast<int>(static_cast<int64_t>(getCount()) * (slice + 1) / sliceCount);
+            stepRange(first, last, stepActions);
+        };
+    }
+    reset(); // Seed every slot, so stepping before the first reset plays distinct games
+}
+
+uint32_t BatchEnv::seedFor(int index) const {
+    // Distinct for every slot and episode as long as count * episodes stays below 2^32
+    return seed + static_cast<uint32_t>(index) + episodes[index] * static_cast<uint32_t>(games.size());
+}
+
+void BatchEnv::reset() {
+    for (int i = 0; i < getCount(); ++i) {
+        episodes[i] = 0;
+        games[i].reset(seedFor(i));
+        if (buffers.reward) buffers.reward[i] = 0.0f;
+        if (buffers.done) buffers.done[i] = 0;
+        observe(i);
+    }
+}
+
+void BatchEnv::step(const uint8_t* actions) {
+    if (!pool) {
+        stepRange(0, getCount(), actions);
+        return;
+    }
+    stepActions = actions;
+    pool->run(sliceCount, stepSlice);
+}
+
+void BatchEnv::stepRange(int first, int last, const uint8_t* actions) {
+    for (int i = first; i < last; ++i) {
+        GameCore& game = games[i];
+        int scoreBefore = game.getScore();
+        game.step(static_cast<Input>(actions[i] & ACTION_MASK), ticksPerStep);
+
+        if (buffers.reward) buffers.reward[i] = static_cast<float>(game.getScore() - scoreBefore);
+        bool done = game.isGameOver();
+        if (buffers.done) buffers.done[i] = done;
+        if (done) {
+            ++episodes[i];
+            game.reset(seedFor(i));
+        }
+        observe(i);
+    }
+}
+
+void BatchEnv::observe(int index) {
+    const GameCore& game = games[index];
+    if (buffers.occupancy) {
+        uint8_t* cells = buffers.occupancy + static_cast<size_t>(index) * Board::HEIGHT * Board::WIDTH;
+        for (int y = 0; y < Board::HEIGHT; ++y) {
+            std::memcpy(cells + y * Board::WIDTH, ROW_CELLS[game.getBoard().getRow(y)].data(), Board::WIDTH);
+        }
+    }
+
+    const Tetromino& piece = game.getCurrentTetromino();
+    if (buffers.piece_type) buffers.piece_type[index] = static_cast<int8_t>(piece.getType());
+    if (buffers.piece_rotation) buffers.piece_rotation[index] = static_cast<int8_t>(piece.getRotation());
+    if (buffers.piece_x) buffers.piece_x[index] = static_cast<int8_t>(piece.getX());
+    if (buffers.piece_y) buffers.piece_y[index] = static_cast<int8_t>(piece.getY());
+    if (buffers.next_type) buffers.next_type[index] = static_cast<int8_t>(game.getNextTetromino().getType());
+    if (buffers.held_type) buffers.held_type[index] = static_cast<int8_t>(game.getHeldTetromino().getType());
+    if (buffers.score) buffers.score[index] = game.getScore();
+    if (buffers.level) buffers.level[index] = game.getLevel();
+}
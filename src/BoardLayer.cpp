@@ -0,0 +1,70 @@
+#include "BoardLayer.h"
+#include <iostream>
+
+BoardLayer::BoardLayer() : owner(nullptr), texture(nullptr), textureCellSize(0), textureRevision(0), valid(false), cached(true) {}
+
+BoardLayer::~BoardLayer() {
+    release();
+}
+
+void BoardLayer::release() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+    owner = nullptr;
+    valid = false;
+}
+
+void BoardLayer::setCached(bool enabled) {
+    cached = enabled;
+    if (!cached) release();
+}
+
+void BoardLayer::drawCells(SDL_Renderer* renderer, CellBatch& batch, const Board& board, int cellSize, int x, int y) {
+    batch.addBoard(board, cellSize, x, y);
+    batch.flush();
+
+    // Draw border around the game area
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255); // White border
+    SDL_Rect borderRect = {x, y, Board::WIDTH * cellSize, Board::HEIGHT * cellSize};
+    SDL_RenderDrawRect(renderer, &borderRect);
+}
+
+bool BoardLayer::prepare(SDL_Renderer* renderer, int cellSize) {
+    if (renderer == owner && cellSize == textureCellSize) return texture != nullptr;
+
+    release();
+    owner = renderer;
+    textureCellSize = cellSize;
+    if (!SDL_RenderTargetSupported(renderer)) return false;
+
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, Board::WIDTH * cellSize, Board::HEIGHT * cellSize);
+    if (texture == nullptr) {
+        std::cerr << "Unable to create board texture; drawing cells directly. SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE); // Opaque: empty cells are the black background
+    return true;
+}
+
+void BoardLayer::draw(SDL_Renderer* renderer, CellBatch& batch, const Board& board, uint64_t revision, int cellSize, int x, int y) {
+    if (!cached || !prepare(renderer, cellSize)) {
+        drawCells(renderer, batch, board, cellSize, x, y);
+        return;
+    }
+
+    if (!valid || revision != textureRevision) {
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+        SDL_SetRenderTarget(renderer, texture);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        drawCells(renderer, batch, board, cellSize, 0, 0);
+        SDL_SetRenderTarget(renderer, previousTarget);
+        textureRevision = revision;
+        valid = true;
+    }
+
+    SDL_Rect destination = {x, y, Board::WIDTH * cellSize, Board::HEIGHT * cellSize};
+    SDL_RenderCopy(renderer, texture, nullptr, &destination);
+}
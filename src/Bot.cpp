@@ -0,0 +1,256 @@
+#include "Bot.h"
+#include "FeatureBatch.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <numeric>
+
+BoardFeatures computeFeatures(const Board& board) {
+    int heights[Board::WIDTH] = {};
+    int holes = 0;
+    Board::Row covered = 0; // Columns with a filled cell somewhere above the current row
+
+    for (int y = 0; y < Board::HEIGHT; ++y) {
+        Board::Row row = board.getRow(y);
+        Board::Row newTops = row & ~covered;
+        while (newTops) {
+            int x = __builtin_ctz(newTops);
+            newTops &= newTops - 1;
+            heights[x] = Board::HEIGHT - y;
+        }
+        holes += __builtin_popcount(covered & ~row & Board::FULL_ROW);
+        covered |= row;
+    }
+
+    BoardFeatures features = {0, holes, 0, 0};
+    for (int x = 0; x < Board::WIDTH; ++x) {
+        features.aggregateHeight += heights[x];
+        if (x + 1 < Board::WIDTH) {
+            features.bumpiness += std::abs(heights[x] - heights[x + 1]);
+        }
+        int left = x > 0 ? heights[x - 1] : Board::HEIGHT;
+        int right = x + 1 < Board::WIDTH ? heights[x + 1] : Board::HEIGHT;
+        int depth = std::min(left, right) - heights[x];
+        if (depth > 0) {
+            features.wells += depth;
+        }
+    }
+    return features;
+}
+
+float evaluate(const BoardFeatures& features, int linesCleared, const EvalWeights& weights) {
+    return weights.aggregateHeight * features.aggregateHeight
+         + weights.holes * features.holes
+         + weights.bumpiness * features.bumpiness
+         + weights.wells * features.wells
+         + weights.linesCleared * linesCleared;
+}
+
+// Features fit in 16 bits each: heights, holes and wells are all below WIDTH * HEIGHT * 2
+static uint64_t packFeatures(const BoardFeatures& features) {
+    return static_cast<uint64_t>(features.aggregateHeight) | static_cast<uint64_t>(features.holes) << 16
+         | static_cast<uint64_t>(features.bumpiness) << 32 | static_cast<uint64_t>(features.wells) << 48;
+}
+
+static BoardFeatures unpackFeatures(uint64_t packed) {
+    return {static_cast<int>(packed & 0xFFFF), static_cast<int>((packed >> 16) & 0xFFFF),
+            static_cast<int>((packed >> 32) & 0xFFFF), static_cast<int>(packed >> 48)};
+}
+
+Bot::Bot(const BotConfig& config) : config(config), planPiece(-1), planHeld(false), pathLength(0), pathStep(0) {
+    // Sized up front for the worst case, so searching allocates nothing in play: every beam node
+    // expands the current and the held piece, each into at most a full PlacementList. Pages
+    // that are never touched cost address space only.
+    size_t width = static_cast<size_t>(std::max(1, config.beamWidth));
+    beam.reserve(width);
+    candidates.reserve(width * 2 * PlacementList::CAPACITY);
+    order.reserve(candidates.capacity());
+    kept.reserve(width);
+    batchBoards.reserve(candidates.capacity());
+    batchFeatures.reserve(candidates.capacity() * BATCH_FEATURES);
+}
+
+BoardFeatures Bot::features(const Board& board) {
+    if (config.table == nullptr) return computeFeatures(board);
+
+    uint64_t packed;
+    if (config.table->probe(board.getHash(), packed)) return unpackFeatures(packed);
+    BoardFeatures computed = computeFeatures(board);
+    config.table->store(board.getHash(), packFeatures(computed));
+    return computed;
+}
+
+void Bot::scoreCandidates() {
+    // The feature cache works board by board, and the portable batch kernel computes more
+    // features than the bot needs, so it only pays off when vectorized
+    if (config.table != nullptr || !featureBatchIsVectorized()) {
+        for (Node& node : candidates) {
+            node.score = evaluate(features(node.board), node.lines, config.weights);
+        }
+        return;
+    }
+
+    // One batch for the whole depth keeps the vector kernel's lanes full
+    size_t count = candidates.size();
+    batchBoards.clear();
+    for (const Node& node : candidates) {
+        batchBoards.push_back(&node.board);
+    }
+    batchFeatures.resize(count * BATCH_FEATURES);
+    int16_t* columns = batchFeatures.data();
+    FeatureArrays out = {nullptr, columns, columns + count, columns + 2 * count, columns + 3 * count,
+                         columns + 4 * count, columns + 5 * count, columns + 6 * count};
+    computeFeatureBatch(batchBoards.data(), count, out);
+    for (size_t i = 0; i < count; ++i) {
+        BoardFeatures features = {out.aggregateHeight[i], out.holes[i], out.bumpiness[i], out.wells[i]};
+        candidates[i].score = evaluate(features, candidates[i].lines, config.weights);
+    }
+}
+
+void Bot::keepBest() {
+    // Best first by score, dropping transpositions: different move orders that end in the same
+    // stack with the same piece held and the same piece to come would fill the beam with copies
+    size_t width = static_cast<size_t>(std::max(1, config.beamWidth));
+    auto better = [this](int a, int b) { return candidates[a].score > candidates[b].score; };
+    order.resize(candidates.size());
+    std::iota(order.begin(), order.end(), 0);
+    size_t sorted = std::min(order.size(), width * 2); // Room for a few duplicates; the rest is sorted only if needed
+    std::partial_sort(order.begin(), order.begin() + sorted, order.end(), better);
+
+    beam.clear();
+    kept.clear();
+    for (size_t i = 0; i < order.size() && beam.size() < width; ++i) {
+        if (i == sorted) {
+            std::sort(order.begin() + sorted, order.end(), better);
+        }
+        const Node& node = candidates[order[i]];
+        uint64_t hash = node.board.getHash() ^ Zobrist::heldKey(node.held) ^ (static_cast<uint64_t>(node.queueIndex) * 0x9E3779B97F4A7C15ull);
+        if (std::find(kept.begin(), kept.end(), hash) != kept.end()) continue;
+        kept.push_back(hash);
+        beam.push_back(node);
+    }
+}
+
+void Bot::expand(const Node& node, const Tetromino& start, const Tetromino& held, int queueIndex, bool useHold, bool root) {
+    generatePlacements(node.board, start, placements);
+    for (const Placement& placement : placements) {
+        candidates.push_back(node);
+        Node& child = candidates.back();
+        child.board.addTetromino(placement.toTetromino());
+        child.lines += child.board.clearLines();
+        child.held = held;
+        child.queueIndex = queueIndex;
+        if (root) {
+            child.firstUseHold = useHold;
+            child.firstPlacement = placement;
+        }
+    }
+}
+
+BotDecision Bot::think(const GameCore& game) {
+    BotDecision decision;
+    if (game.isGameOver()) return decision;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(config.timeBudgetMicros);
+    const Tetromino queue[2] = {game.getCurrentTetromino(), GameCore::atSpawn(game.getNextTetromino())};
+    const int queueLength = 2;
+
+    // First piece: place the current piece where it is, or swap with hold first
+    Node root = {game.getBoard(), game.getHeldTetromino(), 0, 0, 0.0f, false, decision.placement};
+    candidates.clear();
+    expand(root, queue[0], root.held, 1, false, true);
+    if (game.canHold()) {
+        if (root.held.getType() == TetrominoType::None) {
+            expand(root, queue[1], queue[0], 2, true, true); // Hold current, next comes in
+        } else {
+            expand(root, GameCore::atSpawn(root.held), queue[0], 1, true, true);
+        }
+    }
+    scoreCandidates();
+    keepBest();
+
+    // Deeper pieces, as long as the time budget allows
+    for (int depth = 1; depth < config.depth; ++depth) {
+        candidates.clear();
+        bool outOfTime = false;
+        for (const Node& node : beam) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                outOfTime = true;
+                break;
+            }
+            if (node.queueIndex >= queueLength) { // No more known pieces
+                candidates.push_back(node);
+                continue;
+            }
+            const Tetromino& piece = queue[node.queueIndex];
+            expand(node, piece, node.held, node.queueIndex + 1, false, false);
+            if (node.held.getType() == TetrominoType::None) {
+                if (node.queueIndex + 1 < queueLength) {
+                    expand(node, queue[node.queueIndex + 1], piece, node.queueIndex + 2, true, false);
+                }
+            } else {
+                expand(node, GameCore::atSpawn(node.held), piece, node.queueIndex + 1, true, false);
+            }
+        }
+        if (outOfTime || candidates.empty()) break; // Keep the last fully searched depth
+        scoreCandidates(); // Nodes carried over unexpanded score the same again
+        keepBest();
+    }
+
+    if (beam.empty()) return decision;
+
+    const Node& best = *std::max_element(beam.begin(), beam.end(), [](const Node& a, const Node& b) { return a.score < b.score; });
+    decision.found = true;
+    decision.useHold = best.firstUseHold;
+    decision.placement = best.firstPlacement;
+    decision.score = best.score;
+    return decision;
+}
+
+bool Bot::findPath(const GameCore& game) {
+    pathStep = 0;
+    Tetromino positions[MAX_PATH];
+    pathLength = findInputPath(game.getBoard(), game.getCurrentTetromino(), plan.placement, path, MAX_PATH, positions);
+    if (pathLength <= 0) return false;
+
+    // Position hashes along the path, built as GameCore::getPositionHash builds them, so later
+    // calls can tell whether the game is still on it
+    uint64_t fixed = game.getBoard().getHash() ^ Zobrist::heldKey(game.getHeldTetromino());
+    for (int i = 0; i < pathLength; ++i) {
+        pathHashes[i] = fixed ^ Zobrist::pieceKey(positions[i]);
+    }
+    return true;
+}
+
+Input Bot::nextInput(const GameCore& game) {
+    if (game.isGameOver() || game.isPaused()) return Input::None;
+
+    if (planPiece != game.getPiecesPlaced()) {
+        plan = think(game);
+        planPiece = game.getPiecesPlaced();
+        planHeld = false;
+        pathLength = 0;
+    }
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (!plan.found) return Input::HardDrop; // Nowhere to go: just drop it
+
+        if (plan.useHold && !planHeld) {
+            planHeld = true;
+            if (game.canHold()) return Input::Hold;
+        }
+
+        // Still where the path expects: the rest of it is still a shortest path
+        if (pathStep < pathLength && game.getPositionHash() == pathHashes[pathStep]) {
+            return path[pathStep++];
+        }
+        if (findPath(game)) return path[pathStep++];
+
+        // Gravity moved the piece off its path: plan again from where it is now
+        plan = think(game);
+        planHeld = false;
+        pathLength = 0;
+    }
+    return Input::HardDrop;
+}
@@ -0,0 +1,48 @@
+#include "CellBatch.h"
+
+CellBatch::CellBatch() : renderer(nullptr), immediate(false) {}
+
+void CellBatch::begin(SDL_Renderer* target) {
+    renderer = target;
+    for (Bucket& bucket : buckets) {
+        bucket.rects.clear();
+    }
+}
+
+void CellBatch::add(SDL_Color color, const SDL_Rect& rect) {
+    if (immediate) {
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderFillRect(renderer, &rect);
+        return;
+    }
+
+    // A frame uses only a handful of colors, so a linear scan beats hashing
+    for (Bucket& bucket : buckets) {
+        if (bucket.color.r == color.r && bucket.color.g == color.g && bucket.color.b == color.b && bucket.color.a == color.a) {
+            bucket.rects.push_back(rect);
+            return;
+        }
+    }
+    buckets.push_back({color, {rect}});
+}
+
+void CellBatch::addBoard(const Board& board, int cellSize, int x, int y) {
+    for (int row = 0; row < Board::HEIGHT; ++row) {
+        Board::Row bits = board.getRow(row);
+        for (int column = 0; bits != 0; ++column, bits >>= 1) {
+            if (bits & 1u) { // Only occupied cells
+                add(toSDLColor(board.getCellColor(column, row)), {x + column * cellSize, y + row * cellSize, cellSize, cellSize});
+            }
+        }
+    }
+}
+
+void CellBatch::flush() {
+    for (Bucket& bucket : buckets) {
+        if (bucket.rects.empty()) continue;
+
+        SDL_SetRenderDrawColor(renderer, bucket.color.r, bucket.color.g, bucket.color.b, bucket.color.a);
+        SDL_RenderFillRects(renderer, bucket.rects.data(), static_cast<int>(bucket.rects.size()));
+        bucket.rects.clear();
+    }
+}
@@ -0,0 +1,203 @@
+#include "FeatureBatch.h"
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TETROMINO_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const int WIDTH = Board::WIDTH;
+const int HEIGHT = Board::HEIGHT;
+const uint32_t WALLED_ROW = 1u | 1u << (WIDTH + 1); // A row shifted up one bit, between two filled walls
+const uint32_t PAIR_MASK = (1u << (WIDTH + 1)) - 1; // The WIDTH + 1 neighbouring pairs of a walled row
+
+// Portable builds have no popcount instruction, and __builtin_popcount becomes a library call
+inline int popcount16(uint32_t x) {
+    x = x - ((x >> 1) & 0x5555);
+    x = (x & 0x3333) + ((x >> 2) & 0x3333);
+    x = (x + (x >> 4)) & 0x0F0F;
+    return static_cast<int>((x + (x >> 8)) & 0x1F);
+}
+
+#ifdef TETROMINO_HAVE_AVX2_KERNEL
+
+const int LANES = 16; // Boards per pass: one 16-bit row per lane
+static_assert(sizeof(Board::Row) == 2, "the AVX2 kernel packs one row per 16-bit lane");
+
+__attribute__((target("avx2"))) inline __m256i popcount16x16(__m256i x) {
+    // Nibble lookup per byte, then the two bytes of each lane added together
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(x, nibble)),
+                                    _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble)));
+    return _mm256_add_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0xFF)), _mm256_srli_epi16(bytes, 8));
+}
+
+__attribute__((target("avx2"))) void computeFeatureBatchAvx2(const Board* const* boards, size_t count, const FeatureArrays& out) {
+    const __m256i full = _mm256_set1_epi16(static_cast<short>(Board::FULL_ROW));
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i walls = _mm256_set1_epi16(static_cast<short>(WALLED_ROW));
+    const __m256i pairs = _mm256_set1_epi16(static_cast<short>(PAIR_MASK));
+    const __m256i floor = _mm256_set1_epi16(HEIGHT); // Walls count as full columns for wells
+
+    alignas(32) uint16_t rows[HEIGHT][LANES];
+    alignas(32) int16_t lanes[WIDTH + 6][LANES]; // Heights, then the six counts, for the scalar stores
+
+    for (size_t first = 0; first < count; first += LANES) {
+        int active = static_cast<int>(std::min<size_t>(LANES, count - first));
+        // Transpose the boards so row y of all of them is one vector; spare lanes are empty boards
+        for (int lane = 0; lane < LANES; ++lane) {
+            for (int y = 0; y < HEIGHT; ++y) {
+                rows[y][lane] = lane < active ? boards[first + lane]->getRow(y) : 0;
+            }
+        }
+
+        __m256i covered = _mm256_setzero_si256(); // Columns with a filled cell at or above this row
+        __m256i previous = _mm256_load_si256(reinterpret_cast<const __m256i*>(rows[0]));
+        __m256i holes = _mm256_setzero_si256(), rowTransitions = _mm256_setzero_si256();
+        __m256i columnTransitions = _mm256_setzero_si256(), lines = _mm256_setzero_si256();
+        __m256i heights[WIDTH];
+        for (int x = 0; x < WIDTH; ++x) {
+            heights[x] = _mm256_setzero_si256();
+        }
+
+        for (int y = 0; y < HEIGHT; ++y) {
+            __m256i row = _mm256_load_si256(reinterpret_cast<const __m256i*>(rows[y]));
+            lines = _mm256_sub_epi16(lines, _mm256_cmpeq_epi16(row, full)); // Equal lanes are -1
+            covered = _mm256_or_si256(covered, row);
+            holes = _mm256_add_epi16(holes, popcount16x16(_mm256_andnot_si256(row, covered)));
+            columnTransitions = _mm256_add_epi16(columnTransitions, popcount16x16(_mm256_xor_si256(row, previous)));
+            previous = row;
+            __m256i walled = _mm256_or_si256(_mm256_slli_epi16(row, 1), walls);
+            rowTransitions = _mm256_add_epi16(rowTransitions, popcount16x16(_mm256_and_si256(_mm256_xor_si256(walled, _mm256_srli_epi16(walled, 1)), pairs)));
+            // A column's height is the number of rows at or below its top cell
+            for (int x = 0; x < WIDTH; ++x) {
+                heights[x] = _mm256_add_epi16(heights[x], _mm256_and_si256(_mm256_srli_epi16(covered, x), one));
+            }
+        }
+        columnTransitions = _mm256_add_epi16(columnTransitions, popcount16x16(_mm256_xor_si256(previous, full)));
+
+        __m256i aggregate = _mm256_setzero_si256(), bumpiness = _mm256_setzero_si256(), wells = _mm256_setzero_si256();
+        for (int x = 0; x < WIDTH; ++x) {
+            aggregate = _mm256_add_epi16(aggregate, heights[x]);
+            if (x + 1 < WIDTH) {
+                bumpiness = _mm256_add_epi16(bumpiness, _mm256_abs_epi16(_mm256_sub_epi16(heights[x], heights[x + 1])));
+            }
+            __m256i left = x > 0 ? heights[x - 1] : floor;
+            __m256i right = x + 1 < WIDTH ? heights[x + 1] : floor;
+            __m256i depth = _mm256_sub_epi16(_mm256_min_epi16(left, right), heights[x]);
+            wells = _mm256_add_epi16(wells, _mm256_max_epi16(depth, _mm256_setzero_si256()));
+        }
+
+        for (int x = 0; x < WIDTH; ++x) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[x]), heights[x]);
+        }
+        const __m256i totals[6] = {aggregate, holes, bumpiness, wells, rowTransitions, columnTransitions};
+        int16_t* outputs[7] = {out.aggregateHeight, out.holes, out.bumpiness, out.wells, out.rowTransitions, out.columnTransitions, out.completedLines};
+        for (int i = 0; i < 6; ++i) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[WIDTH + i]), totals[i]);
+        }
+        alignas(32) int16_t completed[LANES];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(completed), lines);
+
+        for (int lane = 0; lane < active; ++lane) {
+            size_t board = first + lane;
+            for (int i = 0; i < 6; ++i) {
+                outputs[i][board] = lanes[WIDTH + i][lane];
+            }
+            outputs[6][board] = completed[lane];
+            if (out.heights) {
+                for (int x = 0; x < WIDTH; ++x) {
+                    out.heights[board * WIDTH + x] = static_cast<uint8_t>(lanes[x][lane]);
+                }
+            }
+        }
+    }
+}
+
+#endif // TETROMINO_HAVE_AVX2_KERNEL
+
+using FeatureKernel = void (*)(const Board* const*, size_t, const FeatureArrays&);
+
+struct KernelChoice {
+    FeatureKernel kernel;
+    const char* name;
+    bool vectorized;
+};
+
+KernelChoice chooseKernel() {
+#ifdef TETROMINO_HAVE_AVX2_KERNEL
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {computeFeatureBatchAvx2, "avx2", true};
+#endif
+    return {computeFeatureBatchScalar, "scalar", false};
+}
+
+const KernelChoice& kernelChoice() {
+    static const KernelChoice choice = chooseKernel();
+    return choice;
+}
+
+} // namespace
+
+void computeFeatureBatchScalar(const Board* const* boards, size_t count, const FeatureArrays& out) {
+    for (size_t i = 0; i < count; ++i) {
+        const Board& board = *boards[i];
+        int heights[WIDTH] = {};
+        int holes = 0, rowTransitions = 0, columnTransitions = 0, lines = 0;
+        Board::Row covered = 0;
+        Board::Row previous = board.getRow(0);
+
+        for (int y = 0; y < HEIGHT; ++y) {
+            Board::Row row = board.getRow(y);
+            Board::Row newTops = row & ~covered;
+            while (newTops) {
+                int x = __builtin_ctz(newTops);
+                newTops &= newTops - 1;
+                heights[x] = HEIGHT - y;
+            }
+            lines += row == Board::FULL_ROW;
+            covered |= row;
+            holes += popcount16(covered & ~row & Board::FULL_ROW);
+            columnTransitions += popcount16(row ^ previous);
+            previous = row;
+            uint32_t walled = static_cast<uint32_t>(row) << 1 | WALLED_ROW;
+            rowTransitions += popcount16((walled ^ (walled >> 1)) & PAIR_MASK);
+        }
+        columnTransitions += popcount16(previous ^ Board::FULL_ROW);
+
+        int aggregate = 0, bumpiness = 0, wells = 0;
+        for (int x = 0; x < WIDTH; ++x) {
+            aggregate += heights[x];
+            if (x + 1 < WIDTH) {
+                bumpiness += std::abs(heights[x] - heights[x + 1]);
+            }
+            int left = x > 0 ? heights[x - 1] : HEIGHT;
+            int right = x + 1 < WIDTH ? heights[x + 1] : HEIGHT;
+            wells += std::max(0, std::min(left, right) - heights[x]);
+            if (out.heights) out.heights[i * WIDTH + x] = static_cast<uint8_t>(heights[x]);
+        }
+        out.aggregateHeight[i] = static_cast<int16_t>(aggregate);
+        out.holes[i] = static_cast<int16_t>(holes);
+        out.bumpiness[i] = static_cast<int16_t>(bumpiness);
+        out.wells[i] = static_cast<int16_t>(wells);
+        out.rowTransitions[i] = static_cast<int16_t>(rowTransitions);
+        out.columnTransitions[i] = static_cast<int16_t>(columnTransitions);
+        out.completedLines[i] = static_cast<int16_t>(lines);
+    }
+}
+
+void computeFeatureBatch(const Board* const* boards, size_t count, const FeatureArrays& out) {
+    kernelChoice().kernel(boards, count, out);
+}
+
+const char* featureBatchKernel() {
+    return kernelChoice().name;
+}
+
+bool featureBatchIsVectorized() {
+    return kernelChoice().vectorized;
+}
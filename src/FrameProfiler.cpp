@@ -0,0 +1,141 @@
+#include "FrameProfiler.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+
+static const char* const PHASE_NAMES[FrameProfiler::PHASE_COUNT + 1] = {
+    "events", "input", "update", "render board", "render ghost", "render pieces", "render text", "render overlay", "present", "frame"};
+
+FrameProfiler::FrameProfiler()
+    : frameStart(now()), phaseStart(), phaseTotal(), frameHistory(), phaseHistory(), allocationHistory(), frameAllocationStart(0),
+      nextFrame(0), frameCount(0), nextPass(0), passCount(0), tracing(false), traceStart(0) {}
+
+FrameProfiler::~FrameProfiler() {
+    stopTrace();
+}
+
+const char* FrameProfiler::phaseName(FramePhase phase) {
+    return PHASE_NAMES[static_cast<int>(phase)];
+}
+
+uint64_t FrameProfiler::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void FrameProfiler::beginFrame() {
+    frameStart = now();
+    frameAllocationStart = AllocTracker::thisThread();
+    std::fill(std::begin(phaseTotal), std::end(phaseTotal), 0);
+}
+
+void FrameProfiler::endPass() {
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        if (isPassPhase(phase)) phaseHistory[phase][nextPass] = static_cast<float>(phaseTotal[phase] / 1e6);
+    }
+    allocationHistory[nextPass] = static_cast<uint32_t>(AllocTracker::thisThread() - frameAllocationStart);
+    nextPass = (nextPass + 1) % HISTORY;
+    passCount = std::min(passCount + 1, HISTORY);
+    std::fill(std::begin(phaseTotal), std::end(phaseTotal), 0); // Ended: a later beginFrame has nothing to drop
+}
+
+void FrameProfiler::endFrame() {
+    uint64_t frameEnd = now();
+    frameHistory[nextFrame] = static_cast<float>((frameEnd - frameStart) / 1e6);
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        if (!isPassPhase(phase)) phaseHistory[phase][nextFrame] = static_cast<float>(phaseTotal[phase] / 1e6);
+    }
+    nextFrame = (nextFrame + 1) % HISTORY;
+    frameCount = std::min(frameCount + 1, HISTORY);
+    endPass();
+
+    if (tracing) addTraceEvent(frameStart, frameEnd, PHASE_COUNT);
+}
+
+void FrameProfiler::begin(FramePhase phase) {
+    phaseStart[static_cast<int>(phase)] = now();
+}
+
+void FrameProfiler::end(FramePhase phase) {
+    int index = static_cast<int>(phase);
+    uint64_t phaseEnd = now();
+    phaseTotal[index] += phaseEnd - phaseStart[index];
+
+    if (tracing) addTraceEvent(phaseStart[index], phaseEnd, static_cast<uint8_t>(index));
+}
+
+double FrameProfiler::percentileOf(const float* samples, int count, double percentile) {
+    if (count == 0) return 0.0;
+
+    float sorted[HISTORY];
+    std::copy(samples, samples + count, sorted);
+    int rank = std::min(count - 1, static_cast<int>(percentile / 100.0 * count));
+    std::nth_element(sorted, sorted + rank, sorted + count);
+    return sorted[rank];
+}
+
+double FrameProfiler::framePercentile(double percentile) const {
+    return percentileOf(frameHistory, frameCount, percentile);
+}
+
+double FrameProfiler::phasePercentile(FramePhase phase, double percentile) const {
+    int index = static_cast<int>(phase);
+    return percentileOf(phaseHistory[index], isPassPhase(index) ? passCount : frameCount, percentile);
+}
+
+uint64_t FrameProfiler::windowAllocations() const {
+    uint64_t sum = 0;
+    for (int i = 0; i < passCount; ++i) {
+        sum += allocationHistory[i];
+    }
+    return sum;
+}
+
+bool FrameProfiler::startTrace(const std::string& path) {
+    stopTrace();
+    tracePath = path;
+    traceStart = now();
+    trace.clear();
+    trace.reserve(1 << 16);
+    tracing = true;
+    return true;
+}
+
+void FrameProfiler::addTraceEvent(uint64_t start, uint64_t end, uint8_t phase) {
+    if (trace.size() == MAX_TRACE_EVENTS) {
+        std::cerr << "Frame trace is full; stopping it" << std::endl;
+        stopTrace();
+        return;
+    }
+    trace.push_back({start - traceStart, static_cast<uint32_t>(end - start), phase});
+}
+
+bool FrameProfiler::stopTrace() {
+    if (!tracing) return false;
+    tracing = false;
+
+    std::FILE* file = std::fopen(tracePath.c_str(), "w");
+    if (file == nullptr) {
+        std::cerr << "Unable to write frame trace " << tracePath << std::endl;
+        return false;
+    }
+
+    // Chrome trace-event format: complete ("X") events with microsecond timestamps
+    std::fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    for (size_t i = 0; i < trace.size(); ++i) {
+        const TraceEvent& event = trace[i];
+        std::fprintf(file, "{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d}%s\n",
+                     PHASE_NAMES[event.phase], event.phase == PHASE_COUNT ? "frame" : "phase", event.start / 1e3, event.duration / 1e3,
+                     event.phase == PHASE_COUNT ? 1 : 2, i + 1 < trace.size() ? "," : "");
+    }
+    std::fprintf(file, "]}\n");
+    std::fclose(file);
+
+    std::cout << "Wrote " << trace.size() << " trace events to " << tracePath << std::endl;
+    trace.clear();
+    trace.shrink_to_fit();
+    return true;
+}
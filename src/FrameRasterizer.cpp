@@ -0,0 +1,210 @@
+#include "FrameRasterizer.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const int GLYPH_WIDTH = 5;
+const int GLYPH_HEIGHT = 7;
+const int TEXT_SCALE = 3;                                  // Font pixels per glyph pixel; about the game's font size
+const int GLYPH_ADVANCE = (GLYPH_WIDTH + 1) * TEXT_SCALE;
+
+struct Glyph {
+    char character;
+    uint8_t rows[GLYPH_HEIGHT]; // Bit 4 is the leftmost column
+};
+
+// Only the characters the game draws; lowercase is drawn as uppercase
+const Glyph GLYPHS[] = {
+    {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}}, {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'2', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}}, {'3', {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}},
+    {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}}, {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+    {'6', {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}}, {'7', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},
+    {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}}, {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},
+    {'A', {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}}, {'C', {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}},
+    {'D', {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}}, {'E', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}},
+    {'G', {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}}, {'H', {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+    {'L', {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}}, {'M', {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}},
+    {'N', {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}}, {'O', {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'P', {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}}, {'R', {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}},
+    {'S', {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}}, {'T', {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},
+    {'U', {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}}, {'V', {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}},
+    {'X', {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}}, {':', {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}},
+};
+
+const Glyph* findGlyph(char c) {
+    if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+    for (const Glyph& glyph : GLYPHS) {
+        if (glyph.character == c) return &glyph;
+    }
+    return nullptr; // Spaces and anything else just advance
+}
+
+inline uint32_t pack(Color color) {
+    return static_cast<uint32_t>(color.r) | static_cast<uint32_t>(color.g) << 8 | static_cast<uint32_t>(color.b) << 16;
+}
+
+} // namespace
+
+FrameRasterizer::FrameRasterizer(int width, int height, int cellSize)
+    : width(width), height(height), cellSize(cellSize > 0 ? cellSize : std::max(1, std::min(width / Board::WIDTH, height / Board::HEIGHT))) {}
+
+void FrameRasterizer::fill(uint32_t* pixels, int x, int y, int w, int h, Color color) const {
+    int left = std::max(0, x), right = std::min(width, x + w);
+    int top = std::max(0, y), bottom = std::min(height, y + h);
+    if (left >= right) return;
+    uint32_t value = pack(color);
+    for (int row = top; row < bottom; ++row) {
+        std::fill(pixels + row * width + left, pixels + row * width + right, value);
+    }
+}
+
+void FrameRasterizer::blend(uint32_t* pixels, int x, int y, int w, int h, Color color, int alpha) const {
+    int left = std::max(0, x), right = std::min(width, x + w);
+    int top = std::max(0, y), bottom = std::min(height, y + h);
+    if (left >= right) return;
+    const uint32_t source[3] = {color.r * static_cast<uint32_t>(alpha), color.g * static_cast<uint32_t>(alpha), color.b * static_cast<uint32_t>(alpha)};
+    const uint32_t keep = static_cast<uint32_t>(255 - alpha);
+    for (int row = top; row < bottom; ++row) {
+        for (uint32_t* pixel = pixels + row * width + left; pixel != pixels + row * width + right; ++pixel) {
+            uint32_t value = 0;
+            for (int channel = 0; channel < 3; ++channel) {
+                uint32_t destination = (*pixel >> (channel * 8)) & 0xFF;
+                value |= ((source[channel] + destination * keep) / 255) << (channel * 8);
+            }
+            *pixel = value;
+        }
+    }
+}
+
+void FrameRasterizer::outline(uint32_t* pixels, int x, int y, int w, int h, Color color) const {
+    // Same pixels as SDL_RenderDrawRect: the outermost ring inside the rectangle
+    fill(pixels, x, y, w, 1, color);
+    fill(pixels, x, y + h - 1, w, 1, color);
+    fill(pixels, x, y, 1, h, color);
+    fill(pixels, x + w - 1, y, 1, h, color);
+}
+
+void FrameRasterizer::drawPiece(uint32_t* pixels, const Tetromino& piece, int x, int y, int size) const {
+    const ShapeData& shape = piece.getShape();
+    for (int i = 0; i < shape.cellCount; ++i) {
+        fill(pixels, x + shape.cellX[i] * size, y + shape.cellY[i] * size, size, size, piece.getColor());
+    }
+}
+
+int FrameRasterizer::drawText(uint32_t* pixels, const char* text, int x, int y, Color color) const {
+    for (; *text; ++text, x += GLYPH_ADVANCE) {
+        const Glyph* glyph = findGlyph(*text);
+        if (glyph == nullptr) continue;
+        for (int row = 0; row < GLYPH_HEIGHT; ++row) {
+            for (int column = 0; column < GLYPH_WIDTH; ++column) {
+                if (glyph->rows[row] & (0x10 >> column)) {
+                    fill(pixels, x + column * TEXT_SCALE, y + row * TEXT_SCALE, TEXT_SCALE, TEXT_SCALE, color);
+                }
+            }
+        }
+    }
+    return x;
+}
+
+void FrameRasterizer::draw(const RenderSnapshot& state, uint32_t* pixels) const {
+    const Color black = {0, 0, 0, 255};
+    const Color white = {255, 255, 255, 255};
+    std::fill(pixels, pixels + static_cast<size_t>(width) * height, pack(black));
+
+    int boardRenderWidth = Board::WIDTH * cellSize;
+    int boardRenderHeight = Board::HEIGHT * cellSize;
+    int offsetX = (width - boardRenderWidth) / 2;
+    int offsetY = (height - boardRenderHeight) / 2;
+
+    // Locked cells and border
+    for (int row = 0; row < Board::HEIGHT; ++row) {
+        Board::Row bits = state.board.getRow(row);
+        for (int column = 0; bits != 0; ++column, bits >>= 1) {
+            if (bits & 1u) {
+                fill(pixels, offsetX + column * cellSize, offsetY + row * cellSize, cellSize, cellSize, state.board.getCellColor(column, row));
+            }
+        }
+    }
+    outline(pixels, offsetX, offsetY, boardRenderWidth, boardRenderHeight, white);
+
+    // Ghost under the falling piece
+    if (!state.gameOver && !state.paused) {
+        const ShapeData& ghostShape = state.ghost.getShape();
+        for (int i = 0; i < ghostShape.cellCount; ++i) {
+            blend(pixels, offsetX + (state.ghost.getX() + ghostShape.cellX[i]) * cellSize, offsetY + (state.ghost.getY() + ghostShape.cellY[i]) * cellSize,
+                  cellSize, cellSize, {100, 100, 100, 255}, 100);
+        }
+        drawPiece(pixels, state.current, offsetX + state.current.getX() * cellSize, offsetY + state.current.getY() * cellSize, cellSize);
+    }
+
+    // Previews at half size
+    drawPiece(pixels, state.next, offsetX + boardRenderWidth + 10, offsetY + 100, cellSize / 2);
+    if (state.held.getType() != TetrominoType::None) {
+        drawPiece(pixels, state.held, offsetX - 100, offsetY + 100, cellSize / 2);
+    }
+
+    char score[16];
+    std::snprintf(score, sizeof(score), "%d", state.score);
+    drawText(pixels, "Next:", offsetX + boardRenderWidth + 10, offsetY + 70, white);
+    drawText(pixels, "Hold:", offsetX - 100, offsetY + 70, white);
+    drawText(pixels, score, drawText(pixels, "Score: ", offsetX + boardRenderWidth + 10, offsetY + 10, white), offsetY + 10, white);
+
+    if (state.gameOver) {
+        blend(pixels, 0, 0, width, height, black, 150);
+        drawText(pixels, "GAME OVER", width / 2 - 70, height / 2 - 30, {255, 0, 0, 255});
+        drawText(pixels, score, drawText(pixels, "Score: ", width / 2 - 60, height / 2 + 10, white), height / 2 + 10, white);
+    } else if (state.paused) {
+        blend(pixels, 0, 0, width, height, black, 150);
+        drawText(pixels, "PAUSED", width / 2 - 50, height / 2 - 20, white);
+    }
+}
+
+size_t FrameRasterizer::yuv420Size(int width, int height) {
+    size_t chroma = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+    return static_cast<size_t>(width) * height + 2 * chroma;
+}
+
+// U and V of the average of four pixels. Red and blue are summed together in the two halves
+// of one word and green in another; sums of four bytes fit in 16 bits.
+static inline void chroma(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint8_t& u, uint8_t& v) {
+    uint32_t redBlue = (a & 0x00FF00FF) + (b & 0x00FF00FF) + (c & 0x00FF00FF) + (d & 0x00FF00FF);
+    uint32_t green = ((a >> 8) & 0xFF) + ((b >> 8) & 0xFF) + ((c >> 8) & 0xFF) + ((d >> 8) & 0xFF);
+    int red = static_cast<int>(((redBlue & 0xFFFF) + 2) >> 2);
+    int blue = static_cast<int>(((redBlue >> 16) + 2) >> 2);
+    int greenAverage = static_cast<int>((green + 2) >> 2);
+    u = static_cast<uint8_t>(((-38 * red - 74 * greenAverage + 112 * blue + 128) >> 8) + 128);
+    v = static_cast<uint8_t>(((112 * red - 94 * greenAverage - 18 * blue + 128) >> 8) + 128);
+}
+
+void FrameRasterizer::toYuv420(const uint32_t* pixels, int width, int height, uint8_t* out) {
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    uint8_t* uPlane = out + static_cast<size_t>(width) * height;
+    uint8_t* vPlane = uPlane + static_cast<size_t>(chromaWidth) * chromaHeight;
+
+    // Plain loops over row pointers with no branches, so the compiler vectorizes them
+    for (int y = 0; y < height; ++y) {
+        const uint32_t* row = pixels + static_cast<size_t>(y) * width;
+        uint8_t* luma = out + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) {
+            uint32_t pixel = row[x];
+            uint32_t r = pixel & 0xFF, g = (pixel >> 8) & 0xFF, b = (pixel >> 16) & 0xFF;
+            luma[x] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        }
+    }
+
+    for (int cy = 0; cy < chromaHeight; ++cy) {
+        const uint32_t* top = pixels + static_cast<size_t>(2 * cy) * width;
+        const uint32_t* bottom = 2 * cy + 1 < height ? top + width : top; // Odd heights repeat the last row
+        uint8_t* u = uPlane + static_cast<size_t>(cy) * chromaWidth;
+        uint8_t* v = vPlane + static_cast<size_t>(cy) * chromaWidth;
+        for (int cx = 0; cx < width / 2; ++cx) {
+            chroma(top[2 * cx], top[2 * cx + 1], bottom[2 * cx], bottom[2 * cx + 1], u[cx], v[cx]);
+        }
+        if (width % 2) { // Odd widths repeat the last column
+            int x = width - 1;
+            chroma(top[x], top[x], bottom[x], bottom[x], u[chromaWidth - 1], v[chromaWidth - 1]);
+        }
+    }
+}
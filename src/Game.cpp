@@ -1,45 +1,19 @@
 #include "Game.h"
-#include <iostream>
-#include <chrono>
+#include "AllocTracker.h"
+#include <cstdio>
 #include <string>
 
-Game::Game() : score(0), level(1), gameOver(false), paused(false), canSwap(true), lastFallTime(SDL_GetTicks()), fallDelay(1000) {
-    rng.seed(std::chrono::system_clock::now().time_since_epoch().count());
-    spawnTetromino();
-
-    font = TTF_OpenFont("build/Array-Regular.otf", 24); // Load font
-    if (font == nullptr) {
-        std::cerr << "Failed to load font! SDL_ttf Error: " << TTF_GetError() << std::endl;
-    }
-
-    // Load music and sound effects
-    backgroundMusic = Mix_LoadMUS("assets/sounds/tetris-theme.mp3");
-    if (backgroundMusic == nullptr) {
-        std::cerr << "Failed to load background music! SDL_mixer Error: " << Mix_GetError() << std::endl;
-    }
-
-    moveSound = Mix_LoadWAV("assets/sounds/blip-131856.mp3");
-    if (moveSound == nullptr) {
-        std::cerr << "Failed to load move sound! SDL_mixer Error: " << Mix_GetError() << std::endl;
-    }
-
-    scoreSound = Mix_LoadWAV("assets/sounds/nintendo-game-boy-startup.mp3");
-    if (scoreSound == nullptr) {
-        std::cerr << "Failed to load score sound! SDL_mixer Error: " << Mix_GetError() << std::endl;
-    }
-
-    gameOverSound = Mix_LoadWAV("assets/sounds/game-over-classic-206486.mp3");
-    if (gameOverSound == nullptr) {
-        std::cerr << "Failed to load game over sound! SDL_mixer Error: " << Mix_GetError() << std::endl;
-    }
-
-    // Play background music
-    if (backgroundMusic) {
-        Mix_PlayMusic(backgroundMusic, -1); // Loop indefinitely
-    }
+Game::Game(uint32_t seed, const std::string& assetPack) : sim(seed), snapshotEvent(SDL_RegisterEvents(1)), snapshotPosted(false),
+                            heardMoves(0), heardClears(0), wasPaused(false), wasGameOver(false),
+                            profiler(nullptr), showProfiler(false), dirty(true), assetsLoaded(false), font(nullptr),
+                            backgroundMusic(nullptr), moveSound(nullptr), scoreSound(nullptr), gameOverSound(nullptr) {
+    takeSnapshot();
+    loader.start(assetPack); // Until it finishes the game runs without text and sound
 }
 
 Game::~Game() {
+    sim.stop(); // Nothing may post events or touch the game once the assets go
+    text.setFont(nullptr); // Release cached text textures before the font
     if (font) {
         TTF_CloseFont(font);
     }
@@ -57,85 +31,131 @@ Game::~Game() {
     }
 }
 
-void Game::spawnTetromino() {
-    currentTetromino = nextTetromino.getType() == TetrominoType::None ? Tetromino(static_cast<TetrominoType>(std::uniform_int_distribution<int>(0, static_cast<int>(TetrominoType::L))(rng))) : nextTetromino;
-    currentTetromino.move(-currentTetromino.getX(), -currentTetromino.getY()); // Reset position
-    currentTetromino.move(Board::WIDTH / 2 - currentTetromino.getShape()[0].size() / 2, 0);
+void Game::start() {
+    sim.start([this] {
+        // Wake the main loop, unless an earlier wake-up hasn't been handled yet
+        if (snapshotEvent != static_cast<Uint32>(-1) && !snapshotPosted.exchange(true)) {
+            SDL_Event event = {};
+            event.type = snapshotEvent;
+            SDL_PushEvent(&event);
+        }
+    });
+}
 
-    nextTetromino = Tetromino(static_cast<TetrominoType>(std::uniform_int_distribution<int>(0, static_cast<int>(TetrominoType::L))(rng)));
-    canSwap = true; // Reset swap ability for new piece
+void Game::addGarbage(int count, int holeX, Color color) {
+    sim.addGarbage(count, holeX, color);
+    takeSnapshot();
+}
 
-    if (board.isCollision(currentTetromino)) {
-        gameOver = true;
-        if (backgroundMusic) Mix_HaltMusic(); // Stop music on game over
-        if (gameOverSound) Mix_PlayChannel(-1, gameOverSound, 0);
-    }
+bool Game::startPlayback(const std::string& path, int ticksPerFrame) {
+    if (!sim.startPlayback(path, ticksPerFrame)) return false;
+
+    if (backgroundMusic) Mix_HaltMusic();
+    takeSnapshot();
+    return true;
 }
 
 void Game::handleInput(SDL_Event& event) {
-    if (event.type == SDL_KEYDOWN) {
-        if (event.key.keysym.sym == SDLK_ESCAPE) {
-            paused = !paused;
-            if (paused) {
-                if (backgroundMusic) Mix_PauseMusic();
-            } else {
-                if (backgroundMusic) Mix_ResumeMusic();
-            }
-            if (moveSound) Mix_PlayChannel(-1, moveSound, 0);
-            return; // Handle pause key immediately
-        }
+    if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+        boardLayer.invalidate(); // The driver dropped texture contents
+        dirty = true;
+        return;
+    }
+    if (event.type != SDL_KEYDOWN || isPlayingBack()) return;
 
-        if (gameOver || paused) {
-            return; // Ignore other inputs if game over or paused
+    if (event.key.keysym.sym == SDLK_a) { // Toggle autoplay
+        sim.send({SimCommand::Kind::ToggleAutoplay, Input::None});
+        return;
+    }
+    if (event.key.keysym.sym == SDLK_F3) { // Toggle the frame time overlay
+        showProfiler = !showProfiler;
+        dirty = true;
+        return;
+    }
+    if (event.key.keysym.sym == SDLK_F4 && profiler) { // Start or stop a frame trace
+        if (!profiler->stopTrace()) {
+            profiler->startTrace("frame-trace.json");
         }
+        dirty = true;
+        return;
+    }
 
-        switch (event.key.keysym.sym) {
-            case SDLK_LEFT:
-                moveTetromino(-1, 0);
-                if (moveSound) Mix_PlayChannel(-1, moveSound, 0);
-                break;
-            case SDLK_RIGHT:
-                moveTetromino(1, 0);
-                if (moveSound) Mix_PlayChannel(-1, moveSound, 0);
-                break;
-            case SDLK_DOWN:
-                if (!moveTetromino(0, 1)) {
-                    lockTetromino();
-                }
-                if (moveSound) Mix_PlayChannel(-1, moveSound, 0);
-                break;
-            case SDLK_UP:
-                rotateTetromino();
-                if (moveSound) Mix_PlayChannel(-1, moveSound, 0);
-                break;
-            case SDLK_SPACE: // Hard drop
-                while (moveTetromino(0, 1)) {
-                    // Keep moving down until collision
-                }
-                lockTetromino();
-                if (moveSound) Mix_PlayChannel(-1, moveSound, 0);
-                break;
-            case SDLK_RETURN:
-                swapTetromino();
-                if (moveSound) Mix_PlayChannel(-1, moveSound, 0);
-                break;
-        }
+    Input input = Input::None;
+    switch (event.key.keysym.sym) {
+        case SDLK_ESCAPE: input = Input::Pause; break;
+        case SDLK_LEFT: input = Input::Left; break;
+        case SDLK_RIGHT: input = Input::Right; break;
+        case SDLK_DOWN: input = Input::SoftDrop; break;
+        case SDLK_UP: input = Input::Rotate; break;
+        case SDLK_SPACE: input = Input::HardDrop; break; // Hard drop
+        case SDLK_RETURN: input = Input::Hold; break;
     }
+    if (input == Input::None) return;
+
+    sim.send({SimCommand::Kind::Input, input}); // Applied on the next tick, one input per tick
+}
+
+void Game::waitForAssets() {
+    if (!assetsLoaded) adoptAssets();
+}
+
+void Game::adoptAssets() {
+    GameAssets assets = loader.take();
+    assetsLoaded = true;
+    font = assets.font;
+    backgroundMusic = assets.music;
+    moveSound = assets.moveSound;
+    scoreSound = assets.scoreSound;
+    gameOverSound = assets.gameOverSound;
+
+    text.setFont(font);
+    if (backgroundMusic && !isPlayingBack() && !isGameOver()) {
+        Mix_PlayMusic(backgroundMusic, -1); // Loop indefinitely
+        if (snapshot().paused) Mix_PauseMusic();
+    }
+    dirty = true; // Text can be drawn now
 }
 
 void Game::update() {
-    if (gameOver || paused) return;
+    if (!assetsLoaded && loader.isReady()) adoptAssets();
+
+    snapshotPosted = false; // Snapshots published from here on post a new event
+    takeSnapshot();
+}
+
+void Game::takeSnapshot() {
+    if (!sim.acquireSnapshot()) return;
+    playEffects(snapshot());
+    dirty = true;
+}
 
-    Uint32 currentTime = SDL_GetTicks();
-    if (currentTime - lastFallTime > fallDelay) {
-        if (!moveTetromino(0, 1)) {
-            lockTetromino();
+void Game::playEffects(const RenderSnapshot& current) {
+    if (current.paused != wasPaused && backgroundMusic && !current.gameOver && !current.playingBack) {
+        if (current.paused) {
+            Mix_PauseMusic();
+        } else {
+            Mix_ResumeMusic();
         }
-        lastFallTime = currentTime;
     }
+    if (current.moveSounds != heardMoves && moveSound) {
+        Mix_PlayChannel(-1, moveSound, 0);
+    }
+    if (current.clearSounds != heardClears && scoreSound) {
+        Mix_PlayChannel(-1, scoreSound, 0);
+    }
+    if (current.gameOver && !wasGameOver && !current.playingBack) {
+        if (backgroundMusic) Mix_HaltMusic(); // Stop music on game over
+        if (gameOverSound) Mix_PlayChannel(-1, gameOverSound, 0);
+    }
+    heardMoves = current.moveSounds;
+    heardClears = current.clearSounds;
+    wasPaused = current.paused;
+    wasGameOver = current.gameOver;
 }
 
 void Game::render(SDL_Renderer* renderer, int cellSize) {
+    dirty = false;
+
     int windowWidth, windowHeight;
     SDL_GetRendererOutputSize(renderer, &windowWidth, &windowHeight);
 
@@ -145,75 +165,64 @@ void Game::render(SDL_Renderer* renderer, int cellSize) {
     int offsetX = (windowWidth - boardRenderWidth) / 2; // Center horizontally
     int offsetY = (windowHeight - boardRenderHeight) / 2; // Center vertically
 
-    // Render board
-    for (int y = 0; y < Board::HEIGHT; ++y) {
-        for (int x = 0; x < Board::WIDTH; ++x) {
-            SDL_Color color = board.getGrid()[y][x];
-            if (color.a != 0) { // Only draw if not transparent
-                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-                SDL_Rect fillRect = {offsetX + (int)(x * cellSize), offsetY + (int)(y * cellSize), cellSize, cellSize};
-                SDL_RenderFillRect(renderer, &fillRect);
-            }
-        }
-    }
+    const RenderSnapshot& state = snapshot();
+    const Tetromino& currentTetromino = state.current;
+    bool gameOver = state.gameOver;
+    bool paused = state.paused;
+    int score = state.score;
 
-    // Draw border around the game area
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255); // White border
-    SDL_Rect borderRect = {offsetX, offsetY, boardRenderWidth, boardRenderHeight};
-    SDL_RenderDrawRect(renderer, &borderRect);
+    batch.begin(renderer);
+
+    // Render board: the locked stack and border, from the cached layer unless the board changed
+    beginPhase(FramePhase::RenderBoard);
+    boardLayer.draw(renderer, batch, state.board, state.boardRevision, cellSize, offsetX, offsetY);
+    endPhase(FramePhase::RenderBoard);
 
     // Render ghost piece
     if (!gameOver && !paused) {
-        Tetromino ghostTetromino = currentTetromino;
-        while (true) {
-            Tetromino tempGhost = ghostTetromino;
-            tempGhost.move(0, 1);
-            if (board.isCollision(tempGhost)) {
-                break;
-            }
-            ghostTetromino.move(0, 1);
-        }
+        beginPhase(FramePhase::RenderGhost);
+        const Tetromino& ghostTetromino = state.ghost;
 
-        const auto& ghostShape = ghostTetromino.getShape();
+        const ShapeData& ghostShape = ghostTetromino.getShape();
         SDL_Color ghostColor = {100, 100, 100, 100}; // Gray, semi-transparent
 
-        for (size_t y = 0; y < ghostShape.size(); ++y) {
-            for (size_t x = 0; x < ghostShape[y].size(); ++x) {
-                if (ghostShape[y][x] != 0) {
-                    SDL_SetRenderDrawColor(renderer, ghostColor.r, ghostColor.g, ghostColor.b, ghostColor.a);
-                    SDL_Rect fillRect = {offsetX + (int)((ghostTetromino.getX() + x) * cellSize), offsetY + (int)((ghostTetromino.getY() + y) * cellSize), cellSize, cellSize};
-                    SDL_RenderFillRect(renderer, &fillRect);
-                }
-            }
+        for (int i = 0; i < ghostShape.cellCount; ++i) {
+            batch.add(ghostColor, {offsetX + (ghostTetromino.getX() + ghostShape.cellX[i]) * cellSize, offsetY + (ghostTetromino.getY() + ghostShape.cellY[i]) * cellSize, cellSize, cellSize});
         }
+        batch.flush(); // Ghost goes under the current piece
+        endPhase(FramePhase::RenderGhost);
     }
 
     // Render current tetromino
+    beginPhase(FramePhase::RenderPieces);
     if (!gameOver && !paused) {
-        const auto& shape = currentTetromino.getShape();
-        SDL_Color color = currentTetromino.getColor();
+        const ShapeData& shape = currentTetromino.getShape();
+        SDL_Color color = toSDLColor(currentTetromino.getColor());
         int tetroX = currentTetromino.getX();
         int tetroY = currentTetromino.getY();
 
-        for (size_t y = 0; y < shape.size(); ++y) {
-            for (size_t x = 0; x < shape[y].size(); ++x) {
-                if (shape[y][x] != 0) {
-                    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-                    SDL_Rect fillRect = {offsetX + (int)((tetroX + x) * cellSize), offsetY + (int)((tetroY + y) * cellSize), cellSize, cellSize};
-                    SDL_RenderFillRect(renderer, &fillRect);
-                }
-            }
+        for (int i = 0; i < shape.cellCount; ++i) {
+            batch.add(color, {offsetX + (tetroX + shape.cellX[i]) * cellSize, offsetY + (tetroY + shape.cellY[i]) * cellSize, cellSize, cellSize});
         }
     }
 
-    // Render score
-    renderText(renderer, "Score: " + std::to_string(score), offsetX + boardRenderWidth + 10, offsetY + 10, {255, 255, 255, 255});
+    // Next and held previews join the current piece's batch
+    renderNextTetromino(cellSize, offsetX + boardRenderWidth + 10, offsetY + 100);
+    renderHeldTetromino(cellSize, offsetX - 100, offsetY + 100); // Position to the left of the board
+    batch.flush();
+    endPhase(FramePhase::RenderPieces);
 
-    // Render next tetromino
-    renderNextTetromino(renderer, cellSize, offsetX + boardRenderWidth + 10, offsetY + 100);
+    // Labels are drawn after the cells, so they stay on top
+    beginPhase(FramePhase::RenderText);
+    const SDL_Color white = {255, 255, 255, 255};
+    text.drawLabel(renderer, "Next:", offsetX + boardRenderWidth + 10, offsetY + 70, white);
+    text.drawLabel(renderer, "Hold:", offsetX - 100, offsetY + 70, white);
+
+    // Render score
+    renderScore(renderer, score, offsetX + boardRenderWidth + 10, offsetY + 10);
+    endPhase(FramePhase::RenderText);
 
-    // Render held tetromino
-    renderHeldTetromino(renderer, cellSize, offsetX - 100, offsetY + 100); // Position to the left of the board
+    beginPhase(FramePhase::RenderOverlay);
 
     // Render game over screen
     if (gameOver) {
@@ -222,8 +231,8 @@ void Game::render(SDL_Renderer* renderer, int cellSize) {
         SDL_Rect overlay = {0, 0, windowWidth, windowHeight};
         SDL_RenderFillRect(renderer, &overlay);
 
-        renderText(renderer, "GAME OVER", (windowWidth / 2) - 70, (windowHeight / 2) - 30, {255, 0, 0, 255});
-        renderText(renderer, "Score: " + std::to_string(score), (windowWidth / 2) - 60, (windowHeight / 2) + 10, {255, 255, 255, 255});
+        text.drawLabel(renderer, "GAME OVER", (windowWidth / 2) - 70, (windowHeight / 2) - 30, {255, 0, 0, 255});
+        renderScore(renderer, score, (windowWidth / 2) - 60, (windowHeight / 2) + 10);
     }
 
     // Render pause screen
@@ -233,136 +242,70 @@ void Game::render(SDL_Renderer* renderer, int cellSize) {
         SDL_Rect overlay = {0, 0, windowWidth, windowHeight};
         SDL_RenderFillRect(renderer, &overlay);
 
-        renderText(renderer, "PAUSED", (windowWidth / 2) - 50, (windowHeight / 2) - 20, {255, 255, 255, 255});
+        text.drawLabel(renderer, "PAUSED", (windowWidth / 2) - 50, (windowHeight / 2) - 20, {255, 255, 255, 255});
     }
-}
 
-bool Game::moveTetromino(int dx, int dy) {
-    Tetromino tempTetromino = currentTetromino; // Create a copy
-    tempTetromino.move(dx, dy); // Move the copy
-    if (board.isCollision(tempTetromino)) {
-        return false; // Collision, so don't move
+    if (showProfiler && profiler) {
+        renderProfiler(renderer);
     }
-    currentTetromino.move(dx, dy); // No collision, apply move to actual tetromino
-    return true;
+    endPhase(FramePhase::RenderOverlay);
 }
 
-void Game::rotateTetromino() {
-    Tetromino tempTetromino = currentTetromino; // Create a copy
-    tempTetromino.rotate(); // Rotate the copy
-    if (board.isCollision(tempTetromino)) {
-        // Simple wall kick for now (needs proper implementation for Tetris)
-        Tetromino testTetromino = tempTetromino;
-        testTetromino.move(1, 0); // Try moving right
-        if (!board.isCollision(testTetromino)) {
-            currentTetromino.rotate();
-            currentTetromino.move(1, 0);
-            return;
-        }
-        testTetromino = tempTetromino;
-        testTetromino.move(-1, 0); // Try moving left
-        if (!board.isCollision(testTetromino)) {
-            currentTetromino.rotate();
-            currentTetromino.move(-1, 0);
-            return;
-        }
-        return; // No valid rotation
+void Game::renderProfiler(SDL_Renderer* renderer) {
+    const int lineHeight = font ? TTF_FontLineSkip(font) : 24;
+    const SDL_Color white = {255, 255, 255, 255};
+    const SDL_Color gray = {180, 180, 180, 255};
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 190);
+    SDL_Rect background = {4, 4, 420, lineHeight * (FrameProfiler::PHASE_COUNT + 3) + 8};
+    SDL_RenderFillRect(renderer, &background);
+
+    char line[96];
+    std::snprintf(line, sizeof(line), "frame  p50 %.2f  p99 %.2f ms  (%d)", profiler->framePercentile(50), profiler->framePercentile(99),
+                  profiler->getFrameCount());
+    text.drawText(renderer, line, 10, 8, white);
+    for (int i = 0; i < FrameProfiler::PHASE_COUNT; ++i) {
+        FramePhase phase = static_cast<FramePhase>(i);
+        std::snprintf(line, sizeof(line), "%s  %.2f  %.2f", FrameProfiler::phaseName(phase), profiler->phasePercentile(phase, 50),
+                      profiler->phasePercentile(phase, 99));
+        text.drawText(renderer, line, 10, 8 + lineHeight * (i + 1), gray);
     }
-    currentTetromino.rotate(); // No collision, apply rotation to actual tetromino
-}
-
-void Game::lockTetromino() {
-    board.addTetromino(currentTetromino);
-    int linesCleared = board.clearLines();
-    updateScore(linesCleared);
-    spawnTetromino();
-    checkGameOver();
-}
-
-void Game::updateScore(int linesCleared) {
-    if (linesCleared > 0) {
-        score += linesCleared * 100 * level; // Simple scoring
-        if (score / 1000 > level -1) { // Increase level every 1000 points
-            level++;
-            fallDelay = std::max(100u, fallDelay - 50u); // Increase speed
-        }
-        if (scoreSound) Mix_PlayChannel(-1, scoreSound, 0);
+    if (AllocTracker::isEnabled()) {
+        // Both should stay put in play; the render count covers the frames in the window
+        std::snprintf(line, sizeof(line), "allocations  render %llu  sim %llu", static_cast<unsigned long long>(profiler->windowAllocations()),
+                      static_cast<unsigned long long>(snapshot().simAllocations));
+        text.drawText(renderer, line, 10, 8 + lineHeight * (FrameProfiler::PHASE_COUNT + 1), gray);
     }
-}
-
-void Game::checkGameOver() {
-    // Game over if new tetromino spawns in a collision state
-    // This is handled in spawnTetromino()
-}
-
-void Game::renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color) {
-    if (font == nullptr) return; // Don't render if font not loaded
-
-    SDL_Surface* textSurface = TTF_RenderText_Solid(font, text.c_str(), color);
-    if (textSurface == nullptr) {
-        std::cerr << "Unable to render text surface! SDL_ttf Error: " << TTF_GetError() << std::endl;
-    } else {
-        SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-        if (textTexture == nullptr) {
-            std::cerr << "Unable to create texture from rendered text! SDL Error: " << SDL_GetError() << std::endl;
-        } else {
-            SDL_Rect renderQuad = {x, y, textSurface->w, textSurface->h};
-            SDL_RenderCopy(renderer, textTexture, nullptr, &renderQuad);
-            SDL_DestroyTexture(textTexture);
-        }
-        SDL_FreeSurface(textSurface);
+    if (profiler->isTracing()) {
+        text.drawText(renderer, "tracing (F4 to stop)", 10, 8 + lineHeight * (FrameProfiler::PHASE_COUNT + 2), {255, 80, 80, 255});
     }
 }
 
-void Game::renderNextTetromino(SDL_Renderer* renderer, int cellSize, int xOffset, int yOffset) {
-    const auto& shape = nextTetromino.getShape();
-    SDL_Color color = nextTetromino.getColor();
+void Game::renderScore(SDL_Renderer* renderer, int value, int x, int y) {
+    const SDL_Color white = {255, 255, 255, 255};
+    text.drawLabel(renderer, "Score: ", x, y, white);
+    text.drawNumber(renderer, value, x + text.labelWidth(renderer, "Score: ", white), y, white);
+}
 
-    renderText(renderer, "Next:", xOffset, yOffset - 30, {255, 255, 255, 255});
+void Game::renderNextTetromino(int cellSize, int xOffset, int yOffset) {
+    const Tetromino& nextTetromino = snapshot().next;
+    const ShapeData& shape = nextTetromino.getShape();
+    SDL_Color color = toSDLColor(nextTetromino.getColor());
 
-    for (size_t y = 0; y < shape.size(); ++y) {
-        for (size_t x = 0; x < shape[y].size(); ++x) {
-            if (shape[y][x] != 0) {
-                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-                SDL_Rect fillRect = {xOffset + (int)(x * cellSize / 2), yOffset + (int)(y * cellSize / 2), cellSize / 2, cellSize / 2}; // Render smaller
-                SDL_RenderFillRect(renderer, &fillRect);
-            }
-        }
+    for (int i = 0; i < shape.cellCount; ++i) {
+        batch.add(color, {xOffset + shape.cellX[i] * cellSize / 2, yOffset + shape.cellY[i] * cellSize / 2, cellSize / 2, cellSize / 2}); // Render smaller
     }
 }
 
-void Game::renderHeldTetromino(SDL_Renderer* renderer, int cellSize, int xOffset, int yOffset) {
-    renderText(renderer, "Hold:", xOffset, yOffset - 30, {255, 255, 255, 255});
-
+void Game::renderHeldTetromino(int cellSize, int xOffset, int yOffset) {
+    const Tetromino& heldTetromino = snapshot().held;
     if (heldTetromino.getType() != TetrominoType::None) {
-        const auto& shape = heldTetromino.getShape();
-        SDL_Color color = heldTetromino.getColor();
-
-        for (size_t y = 0; y < shape.size(); ++y) {
-            for (size_t x = 0; x < shape[y].size(); ++x) {
-                if (shape[y][x] != 0) {
-                    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-                    SDL_Rect fillRect = {xOffset + (int)(x * cellSize / 2), yOffset + (int)(y * cellSize / 2), cellSize / 2, cellSize / 2}; // Render smaller
-                    SDL_RenderFillRect(renderer, &fillRect);
-                }
-            }
-        }
-    }
-}
+        const ShapeData& shape = heldTetromino.getShape();
+        SDL_Color color = toSDLColor(heldTetromino.getColor());
 
-void Game::swapTetromino() {
-    if (!canSwap) return; // Only allow one swap per piece
-
-    if (heldTetromino.getType() == TetrominoType::None) {
-        heldTetromino = currentTetromino;
-        spawnTetromino(); // Spawn a new piece
-    } else {
-        Tetromino temp = currentTetromino;
-        currentTetromino = heldTetromino;
-        heldTetromino = temp;
-        // Reset position of swapped piece to top center
-        currentTetromino.move(-currentTetromino.getX(), -currentTetromino.getY()); // Reset to 0,0
-        currentTetromino.move(Board::WIDTH / 2 - currentTetromino.getShape()[0].size() / 2, 0);
+        for (int i = 0; i < shape.cellCount; ++i) {
+            batch.add(color, {xOffset + shape.cellX[i] * cellSize / 2, yOffset + shape.cellY[i] * cellSize / 2, cellSize / 2, cellSize / 2}); // Render smaller
+        }
     }
-    canSwap = false;
 }
@@ -0,0 +1,216 @@
+#include "GameCore.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <iterator>
+
+// Gravity in ticks: one row per second at level 1, faster each level down to 10 rows per second
+static const uint32_t START_FALL_DELAY = GameCore::TICKS_PER_SECOND;
+static const uint32_t MIN_FALL_DELAY = 6;
+static const uint32_t FALL_DELAY_STEP = 3;
+
+GameCore::GameCore(uint32_t seed) : boardRevision(0) {
+    reset(seed);
+}
+
+void GameCore::reset(uint32_t newSeed) {
+    board.reset();
+    ++boardRevision; // Not restarted, so a new game never matches a revision of the old one
+    currentTetromino = Tetromino();
+    nextTetromino = Tetromino();
+    heldTetromino = Tetromino();
+    score = 0;
+    level = 1;
+    gameOver = false;
+    paused = false;
+    canSwap = true;
+    piecesPlaced = 0;
+    totalLinesCleared = 0;
+    std::fill(std::begin(clearCounts), std::end(clearCounts), 0);
+    seed = newSeed;
+    tick = 0;
+    fallTimer = 0;
+    fallDelay = START_FALL_DELAY;
+    rng.seed(seed);
+
+    StepResult ignored;
+    spawnTetromino(ignored);
+}
+
+StepResult GameCore::step(Input input, uint32_t ticks) {
+    StepResult result;
+    tick += ticks;
+
+    if (hasInput(input, Input::Pause)) {
+        paused = !paused;
+        result.pauseToggled = true;
+    }
+
+    if (gameOver || paused) {
+        return result; // Ignore other inputs and gravity if game over or paused
+    }
+
+    if (hasInput(input, Input::Hold)) {
+        swapTetromino(result);
+    }
+    if (hasInput(input, Input::Rotate)) {
+        rotateTetromino();
+    }
+    if (hasInput(input, Input::Left)) {
+        moveTetromino(-1, 0);
+    }
+    if (hasInput(input, Input::Right)) {
+        moveTetromino(1, 0);
+    }
+    if (hasInput(input, Input::SoftDrop) && !gameOver) {
+        if (!moveTetromino(0, 1)) {
+            lockTetromino(result);
+        }
+    }
+    if (hasInput(input, Input::HardDrop) && !gameOver) {
+        currentTetromino.move(0, getDropDistance());
+        lockTetromino(result);
+    }
+
+    // Gravity, jumping straight from one fall to the next
+    while (!gameOver && ticks > 0) {
+        uint32_t untilFall = fallDelay - fallTimer;
+        if (ticks < untilFall) {
+            fallTimer += ticks;
+            break;
+        }
+        ticks -= untilFall;
+        fallTimer = 0;
+        if (!moveTetromino(0, 1)) {
+            lockTetromino(result);
+        }
+    }
+
+    return result;
+}
+
+int GameCore::getDropDistance() const {
+    if (dropDistance < 0) {
+        dropDistance = board.dropDistance(currentTetromino);
+    }
+    return dropDistance;
+}
+
+uint64_t GameCore::getPositionHash() const {
+    // The board keeps its part up to date; the pieces add a few table lookups
+    return board.getHash() ^ Zobrist::pieceKey(currentTetromino) ^ Zobrist::heldKey(heldTetromino);
+}
+
+void GameCore::addGarbage(int count, int holeX, Color color) {
+    board.addGarbage(count, holeX, color);
+    ++boardRevision;
+    dropDistance = -1;
+    if (board.isCollision(currentTetromino)) {
+        gameOver = true;
+    }
+}
+
+Tetromino GameCore::atSpawn(const Tetromino& tetromino) {
+    Tetromino spawned = tetromino;
+    spawned.move(-spawned.getX(), -spawned.getY()); // Reset position
+    spawned.move(Board::WIDTH / 2 - spawned.getSize() / 2, 0);
+    return spawned;
+}
+
+TetrominoType GameCore::randomType() {
+    // Multiply-shift instead of std::uniform_int_distribution, whose mapping differs between
+    // standard libraries; this keeps a seed's piece sequence the same on every platform
+    uint64_t scaled = static_cast<uint64_t>(rng()) * (static_cast<uint64_t>(TetrominoType::L) + 1);
+    return static_cast<TetrominoType>(scaled >> 32);
+}
+
+void GameCore::spawnTetromino(StepResult& result) {
+    currentTetromino = atSpawn(nextTetromino.getType() == TetrominoType::None ? Tetromino(randomType()) : nextTetromino);
+    dropDistance = -1;
+
+    nextTetromino = Tetromino(randomType());
+    canSwap = true; // Reset swap ability for new piece
+
+    // Game over if new tetromino spawns in a collision state
+    if (board.isCollision(currentTetromino)) {
+        gameOver = true;
+        result.gameOver = true;
+    }
+}
+
+bool GameCore::moveTetromino(int dx, int dy) {
+    Tetromino tempTetromino = currentTetromino; // Create a copy
+    tempTetromino.move(dx, dy); // Move the copy
+    if (board.isCollision(tempTetromino)) {
+        return false; // Collision, so don't move
+    }
+    currentTetromino = tempTetromino;
+    if (dx == 0 && dropDistance >= 0) {
+        dropDistance -= dy; // Falling keeps the landing spot
+    } else {
+        dropDistance = -1;
+    }
+    return true;
+}
+
+void GameCore::rotateTetromino() {
+    Tetromino tempTetromino = currentTetromino; // Create a copy
+    tempTetromino.rotate(); // Rotate the copy
+    if (board.isCollision(tempTetromino)) {
+        // Simple wall kick for now (needs proper implementation for Tetris)
+        tempTetromino.move(1, 0); // Try moving right
+        if (!board.isCollision(tempTetromino)) {
+            currentTetromino = tempTetromino;
+            dropDistance = -1;
+            return;
+        }
+        tempTetromino.move(-2, 0); // Try moving left
+        if (!board.isCollision(tempTetromino)) {
+            currentTetromino = tempTetromino;
+            dropDistance = -1;
+        }
+        return; // No valid rotation
+    }
+    currentTetromino = tempTetromino; // No collision, apply rotation to actual tetromino
+    dropDistance = -1;
+}
+
+void GameCore::lockTetromino(StepResult& result) {
+    board.addTetromino(currentTetromino);
+    int linesCleared = board.clearLines();
+    ++boardRevision;
+    updateScore(linesCleared);
+
+    piecesPlaced++;
+    if (linesCleared > 0) {
+        totalLinesCleared += linesCleared;
+        clearCounts[linesCleared - 1]++;
+    }
+    result.locked = true;
+    result.linesCleared += linesCleared;
+    spawnTetromino(result);
+}
+
+void GameCore::updateScore(int linesCleared) {
+    if (linesCleared > 0) {
+        score += linesCleared * 100 * level; // Simple scoring
+        if (score / 1000 > level - 1) { // Increase level every 1000 points
+            level++;
+            fallDelay = std::max(MIN_FALL_DELAY, fallDelay - FALL_DELAY_STEP); // Increase speed
+            fallTimer = std::min(fallTimer, fallDelay - 1);
+        }
+    }
+}
+
+void GameCore::swapTetromino(StepResult& result) {
+    if (!canSwap) return; // Only allow one swap per piece
+
+    if (heldTetromino.getType() == TetrominoType::None) {
+        heldTetromino = currentTetromino;
+        spawnTetromino(result); // Spawn a new piece
+    } else {
+        std::swap(currentTetromino, heldTetromino);
+        currentTetromino = atSpawn(currentTetromino); // Reset position of swapped piece to top center
+        dropDistance = -1;
+    }
+    canSwap = false;
+}
@@ -0,0 +1,328 @@
+#include "GameServer.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const int EVENT_BATCH = 256;
+static const int POLL_MILLIS = 100;              // How often idle loops check for shutdown
+static const size_t MAX_PENDING_OUTPUT = 1 << 20; // A client this far behind is disconnected
+
+struct GameServer::Connection {
+    int fd;
+    size_t index; // Position in the worker's connection list
+    GameCore game;
+    SessionView sent; // What the client was last told, for deltas
+    std::vector<uint8_t> input;  // Received bytes short of a whole frame
+    std::vector<uint8_t> output; // Replies the socket has not taken yet
+    size_t outputSent = 0;
+    uint32_t watching = EPOLLIN | EPOLLRDHUP; // Events registered with epoll
+    bool peerClosed = false; // Sent EOF; closed once its replies are out
+
+    explicit Connection(int fd) : fd(fd), index(0) {}
+};
+
+static double cpuSeconds() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+GameServer::GameServer(const ServerOptions& options) : options(options), listener(-1), stopping(false) {}
+
+GameServer::~GameServer() {
+    stopping = true;
+    for (std::unique_ptr<Worker>& worker : workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+        for (Connection* connection : worker->connections) {
+            close(connection->fd);
+            delete connection;
+        }
+        for (int fd : worker->inbox) {
+            close(fd);
+        }
+        if (worker->epoll >= 0) close(worker->epoll);
+        if (worker->wakeup >= 0) close(worker->wakeup);
+    }
+    if (listener >= 0) {
+        close(listener);
+        if (options.port == 0) unlink(options.socketPath.c_str());
+    }
+}
+
+bool GameServer::start() {
+    if (options.port != 0) {
+        listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(options.port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            std::cerr << "Unable to listen on 127.0.0.1:" << options.port << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    } else {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (options.socketPath.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Socket path is too long: " << options.socketPath << std::endl;
+            return false;
+        }
+        std::strcpy(address.sun_path, options.socketPath.c_str());
+        unlink(address.sun_path); // Left behind by a server that did not shut down cleanly
+        listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            std::cerr << "Unable to listen on " << options.socketPath << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+    if (listen(listener, SOMAXCONN) < 0) {
+        std::cerr << "listen failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    unsigned threadCount = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threadCount; ++i) {
+        std::unique_ptr<Worker> worker(new Worker());
+        worker->epoll = epoll_create1(EPOLL_CLOEXEC);
+        worker->wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr; // Marks the wakeup eventfd
+        if (worker->epoll < 0 || worker->wakeup < 0 || epoll_ctl(worker->epoll, EPOLL_CTL_ADD, worker->wakeup, &event) < 0) {
+            std::cerr << "Unable to create worker event loop: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        workers.push_back(std::move(worker));
+    }
+    for (std::unique_ptr<Worker>& worker : workers) {
+        Worker* target = worker.get();
+        worker->thread = std::thread([this, target] { workerLoop(*target); });
+    }
+    return true;
+}
+
+void GameServer::run(const std::atomic<bool>& stop) {
+    unsigned nextWorker = 0;
+    uint64_t lastInputs = 0;
+    double lastCpu = cpuSeconds();
+    auto lastStats = std::chrono::steady_clock::now();
+
+    while (!stop) {
+        pollfd ready = {listener, POLLIN, 0};
+        if (poll(&ready, 1, POLL_MILLIS) > 0) acceptAll(nextWorker);
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - lastStats).count();
+        if (options.statsSeconds > 0 && elapsed >= options.statsSeconds) {
+            printStats(lastInputs, lastCpu, elapsed);
+            lastStats = now;
+        }
+    }
+    stopping = true;
+}
+
+void GameServer::acceptAll(unsigned& nextWorker) {
+    while (true) {
+        int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "accept failed: " << std::strerror(errno) << std::endl; // E.g. out of descriptors
+            }
+            return;
+        }
+        if (options.port != 0) {
+            int noDelay = 1; // Replies are tiny and latency-bound
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+
+        // The worker registers the socket itself, so its connections are only ever touched by its thread
+        Worker& worker = *workers[nextWorker];
+        nextWorker = (nextWorker + 1) % workers.size();
+        {
+            std::lock_guard<std::mutex> lock(worker.inboxMutex);
+            worker.inbox.push_back(fd);
+        }
+        uint64_t one = 1;
+        ssize_t written = write(worker.wakeup, &one, sizeof(one));
+        (void)written; // Only fails if the counter would overflow, and then the worker is already awake
+    }
+}
+
+void GameServer::workerLoop(Worker& worker) {
+    epoll_event events[EVENT_BATCH];
+    std::vector<int> adopted;
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        int count = epoll_wait(worker.epoll, events, EVENT_BATCH, POLL_MILLIS);
+        for (int i = 0; i < count; ++i) {
+            Connection* connection = static_cast<Connection*>(events[i].data.ptr);
+            if (connection == nullptr) {
+                uint64_t signals;
+                ssize_t drained = read(worker.wakeup, &signals, sizeof(signals));
+                (void)drained;
+                {
+                    std::lock_guard<std::mutex> lock(worker.inboxMutex);
+                    adopted.swap(worker.inbox);
+                }
+                for (int fd : adopted) {
+                    Connection* added = new Connection(fd);
+                    added->index = worker.connections.size();
+                    worker.connections.push_back(added);
+                    epoll_event event = {};
+                    event.events = EPOLLIN | EPOLLRDHUP;
+                    event.data.ptr = added;
+                    epoll_ctl(worker.epoll, EPOLL_CTL_ADD, fd, &event);
+                    worker.sessions.fetch_add(1, std::memory_order_relaxed);
+                }
+                adopted.clear();
+                continue;
+            }
+
+            bool open = true;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                open = readFrom(worker, *connection); // Reads what is left before noticing a hangup
+            }
+            if (open && (events[i].events & EPOLLOUT)) {
+                open = flush(worker, *connection);
+            }
+            if (!open) closeConnection(worker, connection);
+        }
+    }
+}
+
+bool GameServer::readFrom(Worker& worker, Connection& connection) {
+    uint8_t buffer[16384];
+    while (!connection.peerClosed) {
+        ssize_t count = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (count > 0) {
+            connection.input.insert(connection.input.end(), buffer, buffer + count);
+            if (static_cast<size_t>(count) < sizeof(buffer)) break; // Drained
+        } else if (count == 0) {
+            connection.peerClosed = true; // Maybe only a half-close: still answer what it sent
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    // Handle every whole frame, then send all the replies with one write
+    size_t position = 0;
+    const std::vector<uint8_t>& input = connection.input;
+    while (position < input.size() && input.size() - position > input[position]) {
+        uint8_t length = input[position];
+        if (length == 0 || !handleFrame(worker, connection, &input[position + 1])) {
+            return false; // Protocol error
+        }
+        position += 1 + length;
+    }
+    connection.input.erase(connection.input.begin(), connection.input.begin() + static_cast<std::ptrdiff_t>(position));
+    return flush(worker, connection);
+}
+
+bool GameServer::handleFrame(Worker& worker, Connection& connection, const uint8_t* frame) {
+    uint8_t length = frame[-1];
+    switch (frame[0]) {
+        case ServerProtocol::NEW_GAME: {
+            if (length != 5) return false;
+            uint32_t seed = frame[1] | frame[2] << 8 | frame[3] << 16 | static_cast<uint32_t>(frame[4]) << 24;
+            connection.game.reset(seed);
+            connection.sent = SessionView();
+            break;
+        }
+        case ServerProtocol::INPUT: {
+            if (length != 4) return false;
+            Input input = static_cast<Input>(frame[1] & 0x7F);
+            uint16_t ticks = static_cast<uint16_t>(frame[2] | frame[3] << 8);
+            connection.game.step(input, ticks);
+            worker.inputs.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        default:
+            return false;
+    }
+    ServerProtocol::encodeUpdate(connection.output, connection.game, connection.sent);
+    return true;
+}
+
+bool GameServer::flush(Worker& worker, Connection& connection) {
+    std::vector<uint8_t>& output = connection.output;
+    while (connection.outputSent < output.size()) {
+        ssize_t count = send(connection.fd, output.data() + connection.outputSent, output.size() - connection.outputSent, MSG_NOSIGNAL);
+        if (count > 0) {
+            connection.outputSent += static_cast<size_t>(count);
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    if (connection.outputSent == output.size()) {
+        output.clear();
+        connection.outputSent = 0;
+    } else if (output.size() - connection.outputSent > MAX_PENDING_OUTPUT) {
+        return false; // Not reading its replies
+    }
+
+    // Only wait for writability while replies are queued, and stop reading after EOF
+    bool pending = !output.empty();
+    uint32_t wanted = (connection.peerClosed ? 0u : static_cast<uint32_t>(EPOLLIN | EPOLLRDHUP)) | (pending ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    if (wanted != connection.watching) {
+        epoll_event event = {};
+        event.events = wanted;
+        event.data.ptr = &connection;
+        epoll_ctl(worker.epoll, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.watching = wanted;
+    }
+    return pending || !connection.peerClosed; // A closed peer is let go once it has every reply
+}
+
+void GameServer::closeConnection(Worker& worker, Connection* connection) {
+    close(connection->fd); // Also removes it from the epoll set
+    Connection* last = worker.connections.back();
+    last->index = connection->index;
+    worker.connections[connection->index] = last;
+    worker.connections.pop_back();
+    worker.sessions.fetch_sub(1, std::memory_order_relaxed);
+    delete connection;
+}
+
+void GameServer::printStats(uint64_t& lastInputs, double& lastCpu, double elapsedSeconds) {
+    uint64_t sessions = 0, inputs = 0;
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        sessions += worker->sessions.load(std::memory_order_relaxed);
+        inputs += worker->inputs.load(std::memory_order_relaxed);
+    }
+    double cpu = cpuSeconds();
+    double inputRate = (inputs - lastInputs) / elapsedSeconds;
+    double busyCores = (cpu - lastCpu) / elapsedSeconds;
+    lastInputs = inputs;
+    lastCpu = cpu;
+
+    std::cout << std::fixed << std::setprecision(2) << "Sessions: " << sessions << "  Inputs/s: " << inputRate
+              << "  CPU: " << busyCores << " cores";
+    if (busyCores > 0.01 && inputRate > 0) {
+        // Real-time play sends an input per tick, so this is how many 60 Hz players a core could host
+        std::cout << "  60 Hz sessions/core: " << std::setprecision(0) << inputRate / busyCores / GameCore::TICKS_PER_SECOND;
+    }
+    std::cout << std::endl;
+}
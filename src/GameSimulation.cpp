@@ -0,0 +1,201 @@
+#include "GameSimulation.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <iostream>
+
+static const GameSimulation::Clock::duration TICK_LENGTH = std::chrono::nanoseconds(1000000000 / GameCore::TICKS_PER_SECOND);
+
+static BotConfig autoplayConfig() {
+    BotConfig config;
+    config.timeBudgetMicros = 20000; // Well under the fastest fall delay (6 ticks, 100 ms)
+    return config;
+}
+
+GameSimulation::GameSimulation(uint32_t seed)
+    : core(seed), bot(autoplayConfig()), autoplay(false), ticksSinceAutoplay(0), player(replay), playbackTicks(0),
+      moveSounds(0), clearSounds(0), changed(false), stopping(false), woken(false) {
+    publish();
+}
+
+GameSimulation::~GameSimulation() {
+    stop();
+    recorder.finish(core); // Sessions quit early are recorded as ending here
+}
+
+bool GameSimulation::startPlayback(const std::string& path, int ticksPerFrame) {
+    if (!replay.open(path)) return false;
+
+    recorder.finish(core); // Nothing more to record from this session
+    player.start(core);
+    playbackTicks = std::max(1, ticksPerFrame);
+    autoplay = false;
+    publish();
+    return true;
+}
+
+void GameSimulation::addGarbage(int count, int holeX, Color color) {
+    core.addGarbage(count, holeX, color);
+    publish();
+}
+
+void GameSimulation::advance(uint32_t ticks) {
+    drainCommands();
+    for (uint32_t i = 0; i < ticks; ++i) {
+        tick();
+    }
+    if (changed) publish();
+}
+
+void GameSimulation::start(std::function<void()> onPublish) {
+    this->onPublish = std::move(onPublish);
+    stopping = false;
+    thread = std::thread(&GameSimulation::run, this);
+}
+
+void GameSimulation::stop() {
+    if (!thread.joinable()) return;
+    stopping = true;
+    notify();
+    thread.join();
+}
+
+bool GameSimulation::send(const SimCommand& command) {
+    if (!commands.push(command)) return false;
+    notify(); // Wakes the thread if it sleeps until input, e.g. while paused
+    return true;
+}
+
+bool GameSimulation::acquireSnapshot() {
+    if (!snapshots.acquire()) return false;
+    if (playbackTicks > 0) notify(); // Room for the next playback frame
+    return true;
+}
+
+void GameSimulation::run() {
+    Clock::time_point nextTick = Clock::now() + TICK_LENGTH;
+    while (!stopping) {
+        drainCommands();
+
+        if (playbackTicks > 0) {
+            // One snapshot per frame drawn: wait until the last one has been taken
+            if (player.isFinished() || snapshots.hasUnread()) {
+                sleep(nullptr);
+                continue;
+            }
+            advancePlayback();
+            publish();
+            continue;
+        }
+
+        if (core.isPaused() || core.isGameOver()) {
+            // The clock is stopped; the next input is applied as soon as it arrives
+            if (pendingInputs.empty()) {
+                sleep(nullptr);
+            } else {
+                tick();
+            }
+            nextTick = Clock::now() + TICK_LENGTH;
+        } else {
+            Clock::time_point now = Clock::now();
+            if (now < nextTick) {
+                sleep(&nextTick);
+                continue;
+            }
+            // Run the ticks that are due; after a stall, skip what is beyond the catch-up limit
+            int ticks = 0;
+            while (nextTick <= now && ticks < GameCore::MAX_CATCH_UP_TICKS) {
+                tick();
+                nextTick += TICK_LENGTH;
+                ++ticks;
+            }
+            if (nextTick <= now) nextTick = now + TICK_LENGTH;
+        }
+
+        if (changed) publish();
+    }
+}
+
+void GameSimulation::drainCommands() {
+    SimCommand command;
+    while (commands.pop(command)) {
+        if (command.kind == SimCommand::Kind::ToggleAutoplay) {
+            autoplay = !autoplay;
+        } else if (playbackTicks == 0) {
+            pendingInputs.push(command.input); // Dropped if 256 are already waiting
+        }
+    }
+}
+
+void GameSimulation::tick() {
+    Input input = Input::None;
+    bool fromPlayer = pendingInputs.pop(input);
+    if (!fromPlayer && autoplay && ++ticksSinceAutoplay >= GameCore::AUTOPLAY_INPUT_TICKS) {
+        input = bot.nextInput(core);
+        ticksSinceAutoplay = 0;
+    }
+
+    // Inputs other than pause are ignored if game over or paused
+    bool accepted = input == Input::Pause || (input != Input::None && !core.isGameOver() && !core.isPaused());
+
+    recorder.record(core.getTick(), input);
+    Tetromino before = core.getCurrentTetromino();
+    StepResult result = core.step(input);
+    if (result.gameOver) {
+        recorder.finish(core);
+    }
+    if (fromPlayer && accepted) ++moveSounds;
+    if (result.linesCleared > 0) ++clearSounds;
+
+    const Tetromino& after = core.getCurrentTetromino();
+    if (result.locked || result.pauseToggled || result.gameOver || after.getX() != before.getX() || after.getY() != before.getY()
+        || after.getRotation() != before.getRotation() || after.getType() != before.getType() || (fromPlayer && accepted)) {
+        changed = true;
+    }
+}
+
+void GameSimulation::advancePlayback() {
+    player.advance(core, static_cast<uint64_t>(playbackTicks));
+    if (player.isFinished()) {
+        const ReplaySummary& recorded = player.getSummary();
+        std::cout << "Replay finished at tick " << core.getTick() << ", score " << core.getScore();
+        if (!player.isComplete()) {
+            std::cout << " (recording has no final result)";
+        } else if (recorded.score == core.getScore() && recorded.tick == core.getTick()) {
+            std::cout << " (matches recording)";
+        } else {
+            std::cout << " (MISMATCH: recorded score " << recorded.score << ")";
+        }
+        std::cout << std::endl;
+    }
+}
+
+void GameSimulation::publish() {
+    RenderSnapshot& snapshot = snapshots.back();
+    snapshot.capture(core);
+    snapshot.playingBack = playbackTicks > 0;
+    snapshot.moveSounds = moveSounds;
+    snapshot.clearSounds = clearSounds;
+    snapshot.simAllocations = AllocTracker::thisThread();
+    snapshots.publish();
+    changed = false;
+    if (onPublish) onPublish();
+}
+
+void GameSimulation::sleep(const Clock::time_point* until) {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    auto ready = [this] { return woken || stopping; };
+    if (until) {
+        wake.wait_until(lock, *until, ready);
+    } else {
+        wake.wait(lock, ready);
+    }
+    woken = false;
+}
+
+void GameSimulation::notify() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex); // So a thread about to sleep can't miss it
+        woken = true;
+    }
+    wake.notify_one();
+}
@@ -0,0 +1,198 @@
+#include "GameWall.h"
+#include <algorithm>
+
+static const uint32_t RESTART_DELAY_TICKS = 3 * GameCore::TICKS_PER_SECOND;
+static const int TILE_PADDING = 4; // Pixels around each board
+
+static BotConfig wallBotConfig() {
+    // Many bots share the cores; a shallower search keeps a tick's worth of planning well under a frame
+    BotConfig config;
+    config.beamWidth = 4;
+    config.depth = 1;
+    config.timeBudgetMicros = 2000;
+    return config;
+}
+
+GameWall::GameWall(unsigned threadCount, const std::string& assetPack)
+    : pool(threadCount), tickLength(SDL_GetPerformanceFrequency() / GameCore::TICKS_PER_SECOND),
+      lastCounter(SDL_GetPerformanceCounter()), accumulator(0), font(nullptr), profiler(nullptr) {
+    loader.start(assetPack); // Only the font is used; scores appear once it is loaded
+}
+
+GameWall::~GameWall() {
+    text.setFont(nullptr);
+    if (font) TTF_CloseFont(font);
+}
+
+void GameWall::addBot(uint32_t seed) {
+    boards.push_back(std::unique_ptr<WallBoard>(new WallBoard(seed, wallBotConfig())));
+}
+
+bool GameWall::addReplay(const std::string& path) {
+    std::unique_ptr<WallBoard> board(new WallBoard(0, wallBotConfig()));
+    board->replay.reset(new ReplayReader());
+    if (!board->replay->open(path)) return false;
+    board->player.reset(new ReplayPlayer(*board->replay));
+    board->player->start(board->core);
+    boards.push_back(std::move(board));
+    return true;
+}
+
+void GameWall::takeFont() {
+    GameAssets assets = loader.take();
+    font = assets.font;
+    text.setFont(font);
+    if (assets.music) Mix_FreeMusic(assets.music);
+    if (assets.moveSound) Mix_FreeChunk(assets.moveSound);
+    if (assets.scoreSound) Mix_FreeChunk(assets.scoreSound);
+    if (assets.gameOverSound) Mix_FreeChunk(assets.gameOverSound);
+}
+
+void GameWall::step(WallBoard& board, uint32_t ticks) {
+    if (board.player) {
+        if (!board.player->isFinished()) board.player->advance(board.core, ticks);
+        return;
+    }
+
+    for (uint32_t i = 0; i < ticks; ++i) {
+        if (board.core.isGameOver()) {
+            if (board.restartDelay == 0) {
+                board.restartDelay = RESTART_DELAY_TICKS;
+            } else if (--board.restartDelay == 0) {
+                board.core.reset(board.core.getSeed() + static_cast<uint32_t>(boards.size())); // Seeds stay distinct across boards
+                board.ticksSinceInput = 0;
+            }
+            continue;
+        }
+
+        Input input = Input::None;
+        if (++board.ticksSinceInput >= GameCore::AUTOPLAY_INPUT_TICKS) {
+            input = board.bot.nextInput(board.core);
+            board.ticksSinceInput = 0;
+        }
+        board.core.step(input);
+    }
+}
+
+void GameWall::update() {
+    if (font == nullptr && loader.isReady()) takeFont();
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    accumulator += now - lastCounter;
+    lastCounter = now;
+
+    uint64_t ticks = accumulator / tickLength;
+    accumulator -= ticks * tickLength;
+    if (ticks > static_cast<uint64_t>(GameCore::MAX_CATCH_UP_TICKS)) {
+        ticks = GameCore::MAX_CATCH_UP_TICKS; // After a stall, drop time instead of fast-forwarding
+        accumulator = 0;
+    }
+    if (ticks == 0) return;
+
+    // One job per board: bot planning costs vary, and idle workers steal the slow ones
+    for (const std::unique_ptr<WallBoard>& board : boards) {
+        WallBoard* target = board.get();
+        pool.submit([this, target, ticks] { step(*target, static_cast<uint32_t>(ticks)); });
+    }
+    pool.wait();
+}
+
+void GameWall::render(SDL_Renderer* renderer) {
+    if (boards.empty()) return;
+
+    int windowWidth, windowHeight;
+    SDL_GetRendererOutputSize(renderer, &windowWidth, &windowHeight);
+
+    // Pick the column count that gives the largest cells; a score line goes above each board
+    // if it leaves the board at least four text lines tall
+    int count = static_cast<int>(boards.size());
+    int lineHeight = font ? TTF_FontLineSkip(font) : 0;
+    int columns = 1, cellSize = 0, header = 0;
+    for (int candidate = 1; candidate <= count; ++candidate) {
+        int rows = (count + candidate - 1) / candidate;
+        int tileWidth = windowWidth / candidate - 2 * TILE_PADDING;
+        int tileHeight = windowHeight / rows - 2 * TILE_PADDING;
+        int withScore = std::min(tileWidth / Board::WIDTH, (tileHeight - lineHeight) / Board::HEIGHT);
+        int candidateHeader = withScore * Board::HEIGHT >= 4 * lineHeight && lineHeight > 0 ? lineHeight : 0;
+        int size = candidateHeader ? withScore : std::min(tileWidth / Board::WIDTH, tileHeight / Board::HEIGHT);
+        if (size > cellSize) {
+            columns = candidate;
+            cellSize = size;
+            header = candidateHeader;
+        }
+    }
+    cellSize = std::max(cellSize, 1);
+    int rows = (count + columns - 1) / columns;
+    int tileWidth = windowWidth / columns;
+    int tileHeight = windowHeight / rows;
+    int boardWidth = Board::WIDTH * cellSize;
+    int boardHeight = Board::HEIGHT * cellSize;
+
+    auto origin = [&](int index) {
+        SDL_Point point;
+        point.x = (index % columns) * tileWidth + (tileWidth - boardWidth) / 2;
+        point.y = (index / columns) * tileHeight + (tileHeight - boardHeight + header) / 2;
+        return point;
+    };
+
+    batch.begin(renderer);
+
+    // Locked cells of every board in one batch, then all borders in one call per color
+    beginPhase(FramePhase::RenderBoard);
+    borders[0].clear();
+    borders[1].clear();
+    for (int index = 0; index < count; ++index) {
+        const GameCore& core = boards[index]->core;
+        SDL_Point at = origin(index);
+        batch.addBoard(core.getBoard(), cellSize, at.x, at.y);
+        borders[core.isGameOver() ? 1 : 0].push_back({at.x, at.y, boardWidth, boardHeight});
+    }
+    batch.flush();
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDrawRects(renderer, borders[0].data(), static_cast<int>(borders[0].size()));
+    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); // Finished games
+    SDL_RenderDrawRects(renderer, borders[1].data(), static_cast<int>(borders[1].size()));
+    endPhase(FramePhase::RenderBoard);
+
+    // Ghosts go under the falling pieces, so they get their own flush
+    beginPhase(FramePhase::RenderGhost);
+    const SDL_Color ghostColor = {100, 100, 100, 100};
+    for (int index = 0; index < count; ++index) {
+        const GameCore& core = boards[index]->core;
+        if (core.isGameOver() || core.isPaused()) continue;
+        const Tetromino& piece = core.getCurrentTetromino();
+        const ShapeData& shape = piece.getShape();
+        SDL_Point at = origin(index);
+        int ghostY = piece.getY() + core.getDropDistance();
+        for (int i = 0; i < shape.cellCount; ++i) {
+            batch.add(ghostColor, {at.x + (piece.getX() + shape.cellX[i]) * cellSize, at.y + (ghostY + shape.cellY[i]) * cellSize, cellSize, cellSize});
+        }
+    }
+    batch.flush();
+    endPhase(FramePhase::RenderGhost);
+
+    beginPhase(FramePhase::RenderPieces);
+    for (int index = 0; index < count; ++index) {
+        const GameCore& core = boards[index]->core;
+        if (core.isGameOver() || core.isPaused()) continue;
+        const Tetromino& piece = core.getCurrentTetromino();
+        const ShapeData& shape = piece.getShape();
+        SDL_Point at = origin(index);
+        SDL_Color color = toSDLColor(piece.getColor());
+        for (int i = 0; i < shape.cellCount; ++i) {
+            batch.add(color, {at.x + (piece.getX() + shape.cellX[i]) * cellSize, at.y + (piece.getY() + shape.cellY[i]) * cellSize, cellSize, cellSize});
+        }
+    }
+    batch.flush();
+    endPhase(FramePhase::RenderPieces);
+
+    if (header > 0) {
+        beginPhase(FramePhase::RenderText);
+        const SDL_Color white = {255, 255, 255, 255};
+        for (int index = 0; index < count; ++index) {
+            SDL_Point at = origin(index);
+            text.drawNumber(renderer, boards[index]->core.getScore(), at.x, at.y - header, white);
+        }
+        endPhase(FramePhase::RenderText);
+    }
+}
@@ -0,0 +1,63 @@
+#include "MappedFile.h"
+#include <cstdio>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : bytes(nullptr), length(0), mapped(false) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path, bool sequential) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            if (sequential) madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            bytes = static_cast<const uint8_t*>(view);
+            length = static_cast<size_t>(info.st_size);
+            mapped = true;
+        }
+    }
+    ::close(fd); // The mapping stays valid
+    if (mapped) return true;
+#endif
+
+    // Not mappable (or an empty file): read it instead
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) return false;
+    uint8_t chunk[4096];
+    size_t count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        fallback.insert(fallback.end(), chunk, chunk + count);
+    }
+    std::fclose(file);
+    static const uint8_t empty = 0;
+    bytes = fallback.empty() ? &empty : fallback.data();
+    length = fallback.size();
+    return true;
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(const_cast<uint8_t*>(bytes), length);
+    }
+#endif
+    fallback.clear();
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+}
@@ -0,0 +1,288 @@
+#include "MoveGenerator.h"
+#include "GameCore.h"
+#include <algorithm>
+
+namespace {
+
+using TetrominoTables::ROTATIONS;
+using TetrominoTables::SHAPES;
+using TetrominoTables::TYPE_COUNT;
+
+// Position masks hold one bit per x: bit p is x = p - X_OFFSET, so pieces whose
+// box hangs past the left wall still get a non-negative bit index.
+const int X_OFFSET = 3;
+const int POSITIONS = 16;
+const uint32_t POSITION_MASK = (1u << POSITIONS) - 1;
+
+// Padded rows above the board (for starts with negative y) and below it (floor)
+const int TOP_PADDING = PlacementList::ROWS_ABOVE;
+const int PADDED_ROWS = TOP_PADDING + Board::HEIGHT + 4;
+const int LAST_ROW = TOP_PADDING + Board::HEIGHT; // First row index where every piece hits the floor
+
+// Orientations covering the same cells up to translation share a shape id,
+// e.g. the two horizontal I orientations. Placements are deduplicated on it.
+struct ShapeIds {
+    uint8_t id[TYPE_COUNT][ROTATIONS];
+};
+
+constexpr bool sameCells(const ShapeData& a, const ShapeData& b) {
+    if (a.cellCount != b.cellCount || a.maxY - a.minY != b.maxY - b.minY) return false;
+    for (int i = 0; i <= a.maxY - a.minY; ++i) {
+        if ((a.rows[a.minY + i] >> a.minX) != (b.rows[b.minY + i] >> b.minX)) return false;
+    }
+    return true;
+}
+
+constexpr ShapeIds buildShapeIds() {
+    ShapeIds ids = {};
+    for (int type = 0; type < TYPE_COUNT; ++type) {
+        for (int rotation = 0; rotation < ROTATIONS; ++rotation) {
+            ids.id[type][rotation] = static_cast<uint8_t>(rotation);
+            for (int earlier = 0; earlier < rotation; ++earlier) {
+                if (sameCells(SHAPES[type][earlier], SHAPES[type][rotation])) {
+                    ids.id[type][rotation] = ids.id[type][earlier];
+                    break;
+                }
+            }
+        }
+    }
+    return ids;
+}
+
+constexpr ShapeIds SHAPE_IDS = buildShapeIds();
+
+static_assert(SHAPE_IDS.id[static_cast<int>(TetrominoType::I)][2] == 0, "Horizontal I orientations share cells");
+static_assert(SHAPE_IDS.id[static_cast<int>(TetrominoType::O)][3] == 0, "O has a single shape");
+static_assert(SHAPE_IDS.id[static_cast<int>(TetrominoType::T)][2] == 2, "T orientations are all distinct");
+
+// Spread reachable positions sideways and through rotations until nothing changes
+void closeRow(uint32_t reach[ROTATIONS], const uint32_t freeRow[ROTATIONS]) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int rotation = 0; rotation < ROTATIONS; ++rotation) {
+            uint32_t fits = freeRow[rotation];
+            uint32_t current = reach[rotation];
+            while (true) { // Left/right shifts
+                uint32_t spread = (current | (current << 1) | (current >> 1)) & fits;
+                if (spread == current) break;
+                current = spread;
+            }
+            reach[rotation] = current;
+
+            // Rotation: try in place, then kicked one right, then one left
+            int next = (rotation + 1) & (ROTATIONS - 1);
+            uint32_t nextFits = freeRow[next];
+            uint32_t blocked = current & ~nextFits;
+            uint32_t rotated = (current & nextFits)
+                             | ((blocked << 1) & nextFits)
+                             | (((blocked & ~(nextFits >> 1)) >> 1) & nextFits);
+            uint32_t added = rotated & ~reach[next];
+            if (added) {
+                reach[next] |= added;
+                changed = true;
+            }
+        }
+    }
+}
+
+} // namespace
+
+void generatePlacements(const Board& board, const Tetromino& start, PlacementList& out) {
+    out.clear();
+
+    TetrominoType type = start.getType();
+    int startRow = start.getY() + TOP_PADDING;
+    int startBit = start.getX() + X_OFFSET;
+    if (type == TetrominoType::None || startRow < 0 || startRow >= LAST_ROW || startBit < 0 || startBit >= POSITIONS) {
+        return;
+    }
+    const auto& shapes = SHAPES[static_cast<int>(type)];
+
+    // Board rows in position-mask space, with walls and floor filled in
+    uint32_t padded[PADDED_ROWS];
+    const uint32_t walls = ~(static_cast<uint32_t>(Board::FULL_ROW) << X_OFFSET);
+    int stackTop = LAST_ROW; // First padded row holding any locked cell or the floor
+    for (int i = 0; i < PADDED_ROWS; ++i) {
+        int y = i - TOP_PADDING;
+        padded[i] = y < 0 ? walls : (y < Board::HEIGHT ? walls | (static_cast<uint32_t>(board.getRow(y)) << X_OFFSET) : ~0u);
+        if (padded[i] != walls && i < stackTop) stackTop = i;
+    }
+
+    // Rows whose 4-row box sees only walls all behave like the start row, so after the
+    // start row the search resumes at the last such row instead of walking through them
+    int resumeRow = std::max(startRow + 1, stackTop - 4);
+
+    // fits[i][r]: positions where orientation r fits with its box top at padded row i
+    uint32_t fits[LAST_ROW + 1][ROTATIONS];
+    for (int i = startRow; i <= LAST_ROW; i = (i == startRow ? resumeRow : i + 1)) {
+        for (int rotation = 0; rotation < ROTATIONS; ++rotation) {
+            const ShapeData& shape = shapes[rotation];
+            uint32_t collides = 0;
+            for (int c = 0; c < shape.cellCount; ++c) {
+                collides |= padded[i + shape.cellY[c]] >> shape.cellX[c];
+            }
+            fits[i][rotation] = ~collides & POSITION_MASK;
+        }
+    }
+
+    if (!((fits[startRow][start.getRotation()] >> startBit) & 1)) {
+        return; // Start position already collides
+    }
+
+    uint32_t reach[ROTATIONS] = {0, 0, 0, 0};
+    reach[start.getRotation()] = 1u << startBit;
+    uint16_t seen[ROTATIONS][LAST_ROW] = {}; // Emitted anchors per shape id, bit = anchor x
+
+    for (int i = startRow; i < LAST_ROW; i = (i == startRow ? resumeRow : i + 1)) {
+        if (i > startRow) { // Soft drop from the row above
+            uint32_t any = 0;
+            for (int rotation = 0; rotation < ROTATIONS; ++rotation) {
+                reach[rotation] &= fits[i][rotation];
+                any |= reach[rotation];
+            }
+            if (!any) break;
+        }
+        closeRow(reach, fits[i]);
+
+        // Positions that cannot move down any further are resting placements.
+        // Rows skipped after the start row behave exactly like it.
+        const uint32_t* below = (i == startRow && resumeRow > startRow + 1) ? fits[startRow] : fits[i + 1];
+        for (int rotation = 0; rotation < ROTATIONS; ++rotation) {
+            uint32_t resting = reach[rotation] & ~below[rotation];
+            const ShapeData& shape = shapes[rotation];
+            uint8_t shapeId = SHAPE_IDS.id[static_cast<int>(type)][rotation];
+            while (resting) {
+                int bit = __builtin_ctz(resting);
+                resting &= resting - 1;
+
+                int x = bit - X_OFFSET;
+                int y = i - TOP_PADDING;
+                int anchorX = x + shape.minX;
+                int anchorRow = i + shape.minY;
+                uint16_t anchorBit = static_cast<uint16_t>(1u << anchorX);
+                if (seen[shapeId][anchorRow] & anchorBit) continue;
+                seen[shapeId][anchorRow] |= anchorBit;
+
+                out.push({type, static_cast<uint8_t>(rotation), static_cast<int8_t>(x), static_cast<int8_t>(y)});
+            }
+        }
+    }
+}
+
+void generatePlacements(const Board& board, TetrominoType type, PlacementList& out) {
+    generatePlacements(board, GameCore::atSpawn(Tetromino(type)), out);
+}
+
+int findInputPath(const Board& board, const Tetromino& start, const Placement& target, Input* out, int capacity, Tetromino* positions) {
+    TetrominoType type = start.getType();
+    if (type == TetrominoType::None || type != target.type || board.isCollision(start)) {
+        return -1;
+    }
+
+    const int typeIndex = static_cast<int>(type);
+    const ShapeData& targetShape = SHAPES[typeIndex][target.rotation];
+    const uint8_t targetId = SHAPE_IDS.id[typeIndex][target.rotation];
+    const int targetAnchorX = target.x + targetShape.minX;
+    const int targetAnchorY = target.y + targetShape.minY;
+
+    // Hard dropping from here would land on the target's cells
+    auto dropsOntoTarget = [&](Tetromino tetromino) {
+        const ShapeData& shape = tetromino.getShape();
+        if (SHAPE_IDS.id[typeIndex][tetromino.getRotation()] != targetId || tetromino.getX() + shape.minX != targetAnchorX
+            || tetromino.getY() + shape.minY > targetAnchorY) {
+            return false;
+        }
+        Tetromino below = tetromino;
+        below.move(0, 1);
+        while (!board.isCollision(below)) {
+            tetromino = below;
+            below.move(0, 1);
+        }
+        return tetromino.getY() + shape.minY == targetAnchorY;
+    };
+
+    // Breadth-first search over (rotation, row, x) with the same moves GameCore allows
+    const int STATES = ROTATIONS * PADDED_ROWS * POSITIONS;
+    auto stateOf = [](const Tetromino& tetromino) {
+        return (tetromino.getRotation() * PADDED_ROWS + tetromino.getY() + TOP_PADDING) * POSITIONS + tetromino.getX() + X_OFFSET;
+    };
+
+    auto tetrominoOf = [type](int state) {
+        int x = state % POSITIONS - X_OFFSET;
+        int row = state / POSITIONS;
+        return Tetromino(type, row / PADDED_ROWS, x, row % PADDED_ROWS - TOP_PADDING);
+    };
+
+    int16_t parent[STATES];
+    Input via[STATES];
+    int16_t queue[STATES];
+    uint32_t visited[(STATES + 31) / 32] = {};
+    int head = 0, tail = 0;
+
+    if (start.getY() + TOP_PADDING < 0 || start.getY() + TOP_PADDING >= LAST_ROW || start.getX() + X_OFFSET < 0 || start.getX() + X_OFFSET >= POSITIONS) {
+        return -1;
+    }
+    int startState = stateOf(start);
+    visited[startState / 32] |= 1u << (startState % 32);
+    parent[startState] = -1;
+    queue[tail++] = static_cast<int16_t>(startState);
+
+    while (head < tail) {
+        int currentState = queue[head++];
+        Tetromino current = tetrominoOf(currentState);
+
+        if (dropsOntoTarget(current)) {
+            // Walk back to the start, then write the inputs front to back
+            int length = 1;
+            for (int state = currentState; parent[state] >= 0; state = parent[state]) length++;
+            if (length > capacity) return -1;
+
+            out[length - 1] = Input::HardDrop;
+            if (positions) positions[length - 1] = current;
+            int index = length - 2;
+            for (int state = currentState; parent[state] >= 0; state = parent[state]) {
+                if (positions) positions[index] = tetrominoOf(parent[state]);
+                out[index--] = via[state];
+            }
+            return length;
+        }
+
+        Tetromino moves[4];
+        Input inputs[4];
+        int moveCount = 0;
+
+        Tetromino rotated = current;
+        rotated.rotate();
+        if (board.isCollision(rotated)) { // Right-then-left kick, as in GameCore::rotateTetromino
+            rotated.move(1, 0);
+            if (board.isCollision(rotated)) {
+                rotated.move(-2, 0);
+            }
+        }
+        if (!board.isCollision(rotated)) {
+            moves[moveCount] = rotated;
+            inputs[moveCount++] = Input::Rotate;
+        }
+        const int shifts[3][2] = {{-1, 0}, {1, 0}, {0, 1}};
+        const Input shiftInputs[3] = {Input::Left, Input::Right, Input::SoftDrop};
+        for (int i = 0; i < 3; ++i) {
+            Tetromino moved = current;
+            moved.move(shifts[i][0], shifts[i][1]);
+            if (!board.isCollision(moved)) {
+                moves[moveCount] = moved;
+                inputs[moveCount++] = shiftInputs[i];
+            }
+        }
+
+        for (int i = 0; i < moveCount; ++i) {
+            int state = stateOf(moves[i]);
+            if (visited[state / 32] & (1u << (state % 32))) continue;
+            visited[state / 32] |= 1u << (state % 32);
+            parent[state] = static_cast<int16_t>(currentState);
+            via[state] = inputs[i];
+            queue[tail++] = static_cast<int16_t>(state);
+        }
+    }
+    return -1;
+}
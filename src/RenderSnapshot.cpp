@@ -0,0 +1,19 @@
+#include "RenderSnapshot.h"
+
+void RenderSnapshot::capture(const GameCore& game) {
+    board = game.getBoard();
+    boardRevision = game.getBoardRevision();
+    current = game.getCurrentTetromino();
+    ghost = current;
+    if (!game.isGameOver()) {
+        ghost.move(0, game.getDropDistance());
+    }
+    next = game.getNextTetromino();
+    held = game.getHeldTetromino();
+    score = game.getScore();
+    level = game.getLevel();
+    pieces = game.getPiecesPlaced();
+    tick = game.getTick();
+    paused = game.isPaused();
+    gameOver = game.isGameOver();
+}
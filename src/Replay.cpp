@@ -0,0 +1,245 @@
+#include "Replay.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+static size_t encodeVarint(uint64_t value, uint8_t* out) {
+    size_t count = 0;
+    while (value >= 0x80) {
+        out[count++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[count++] = static_cast<uint8_t>(value);
+    return count;
+}
+
+static bool decodeVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+        uint8_t byte = *cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false; // Ran off the end of the data
+}
+
+static const size_t BUFFER_RESERVE = 64 * 1024; // Minutes of input; the writer drains it far more often
+
+ReplayWriter::ReplayWriter() : file(nullptr), lastTick(0), stopping(false) {}
+
+ReplayWriter::~ReplayWriter() {
+    close();
+}
+
+bool ReplayWriter::open(const std::string& path, uint32_t seed) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Unable to open replay file " << path << " for writing" << std::endl;
+        return false;
+    }
+    lastTick = 0;
+    stopping = false;
+    buffer.reserve(BUFFER_RESERVE);
+
+    uint8_t header[ReplayFormat::HEADER_SIZE] = {};
+    std::memcpy(header, ReplayFormat::MAGIC, sizeof(ReplayFormat::MAGIC));
+    header[4] = ReplayFormat::VERSION;
+    header[5] = static_cast<uint8_t>(GameCore::TICKS_PER_SECOND);
+    for (int i = 0; i < 4; ++i) {
+        header[8 + i] = static_cast<uint8_t>(seed >> (8 * i));
+    }
+    append(header, sizeof(header));
+
+    writer = std::thread(&ReplayWriter::writerLoop, this);
+    return true;
+}
+
+void ReplayWriter::record(uint64_t tick, Input input) {
+    if (file == nullptr || input == Input::None) return;
+
+    uint8_t bytes[11];
+    size_t count = encodeVarint(tick - lastTick, bytes);
+    bytes[count++] = static_cast<uint8_t>(input);
+    lastTick = tick;
+    append(bytes, count);
+}
+
+void ReplayWriter::finish(const GameCore& game) {
+    if (file == nullptr) return;
+
+    uint8_t bytes[48];
+    size_t count = encodeVarint(game.getTick() - lastTick, bytes);
+    bytes[count++] = ReplayFormat::END;
+    count += encodeVarint(static_cast<uint64_t>(game.getScore()), bytes + count);
+    count += encodeVarint(static_cast<uint64_t>(game.getPiecesPlaced()), bytes + count);
+    count += encodeVarint(static_cast<uint64_t>(game.getLinesCleared()), bytes + count);
+    append(bytes, count);
+    close();
+}
+
+void ReplayWriter::append(const uint8_t* bytes, size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer.insert(buffer.end(), bytes, bytes + count);
+    }
+    dataReady.notify_one();
+}
+
+void ReplayWriter::writerLoop() {
+    std::vector<uint8_t> writing;
+    writing.reserve(BUFFER_RESERVE); // Swapped with buffer, so neither side allocates while recording
+    while (true) {
+        bool done;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            dataReady.wait(lock, [this] { return stopping || !buffer.empty(); });
+            writing.swap(buffer);
+            done = stopping;
+        }
+        if (!writing.empty()) {
+            std::fwrite(writing.data(), 1, writing.size(), file);
+            std::fflush(file); // Keep what was recorded so far if the game crashes
+            writing.clear();
+        }
+        if (done) return;
+    }
+}
+
+void ReplayWriter::close() {
+    if (file == nullptr) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    dataReady.notify_one();
+    writer.join();
+    std::fclose(file);
+    file = nullptr;
+}
+
+ReplayReader::ReplayReader() : seed(0) {}
+
+bool ReplayReader::open(const std::string& path) {
+    if (!file.open(path, true)) {
+        std::cerr << "Unable to open replay file " << path << std::endl;
+        return false;
+    }
+
+    const uint8_t* data = file.data();
+    if (file.size() < ReplayFormat::HEADER_SIZE || std::memcmp(data, ReplayFormat::MAGIC, sizeof(ReplayFormat::MAGIC)) != 0) {
+        std::cerr << "Not a replay file: " << path << std::endl;
+        close();
+        return false;
+    }
+    if (data[4] != ReplayFormat::VERSION || data[5] != GameCore::TICKS_PER_SECOND) {
+        std::cerr << "Unsupported replay version " << static_cast<int>(data[4]) << " in " << path << std::endl;
+        close();
+        return false;
+    }
+    seed = 0;
+    for (int i = 0; i < 4; ++i) {
+        seed |= static_cast<uint32_t>(data[8 + i]) << (8 * i);
+    }
+    return true;
+}
+
+void ReplayReader::close() {
+    file.close();
+}
+
+ReplayPlayer::ReplayPlayer(const ReplayReader& reader)
+    : reader(reader), cursor(nullptr), nextTick(0), nextInput(0), finished(true), complete(false), corrupt(false) {}
+
+void ReplayPlayer::start(GameCore& game) {
+    game.reset(reader.getSeed());
+    cursor = reader.begin();
+    nextTick = 0;
+    finished = false;
+    complete = false;
+    corrupt = false;
+    summary = ReplaySummary();
+    readRecord();
+}
+
+void ReplayPlayer::readRecord() {
+    const uint8_t* end = reader.end();
+    if (cursor == end) {
+        finished = true; // Cut short: no trailer
+        return;
+    }
+
+    uint64_t delta;
+    if (!decodeVarint(cursor, end, delta) || cursor == end) {
+        finished = corrupt = true;
+        return;
+    }
+    nextTick += delta;
+    nextInput = *cursor++;
+    if ((nextInput & ReplayFormat::END) && nextInput != ReplayFormat::END) {
+        finished = corrupt = true; // Inputs only use bits 0-6
+        return;
+    }
+
+    if (nextInput == ReplayFormat::END) {
+        uint64_t score, pieces, lines;
+        if (!decodeVarint(cursor, end, score) || !decodeVarint(cursor, end, pieces) || !decodeVarint(cursor, end, lines)) {
+            finished = corrupt = true;
+            return;
+        }
+        summary.tick = nextTick;
+        summary.score = static_cast<int>(score);
+        summary.pieces = static_cast<int>(pieces);
+        summary.lines = static_cast<int>(lines);
+    }
+}
+
+bool ReplayPlayer::advance(GameCore& game, uint64_t ticks) {
+    uint64_t start = game.getTick();
+    uint64_t target = ticks > std::numeric_limits<uint64_t>::max() - start ? std::numeric_limits<uint64_t>::max() : start + ticks;
+
+    while (!finished) {
+        uint64_t now = game.getTick();
+        if (now >= target) return true;
+
+        if (nextTick > now) {
+            // Nothing recorded until nextTick: let gravity run in one jump
+            uint64_t idle = std::min(nextTick, target) - now;
+            game.step(Input::None, static_cast<uint32_t>(std::min<uint64_t>(idle, std::numeric_limits<uint32_t>::max())));
+            continue;
+        }
+
+        if (nextInput == ReplayFormat::END) {
+            finished = complete = true;
+            break;
+        }
+        game.step(static_cast<Input>(nextInput));
+        readRecord();
+    }
+    return false;
+}
+
+ReplayCheck verifyReplay(const std::string& path) {
+    ReplayCheck check;
+    ReplayReader reader;
+    if (!reader.open(path)) return check;
+    check.loaded = true;
+
+    GameCore game;
+    ReplayPlayer player(reader);
+    player.start(game);
+    player.advance(game, std::numeric_limits<uint64_t>::max());
+
+    check.complete = player.isComplete();
+    check.corrupt = player.isCorrupt();
+    check.recorded = player.getSummary();
+    check.replayed.tick = game.getTick();
+    check.replayed.score = game.getScore();
+    check.replayed.pieces = game.getPiecesPlaced();
+    check.replayed.lines = game.getLinesCleared();
+    check.matches = check.complete && !check.corrupt && check.recorded.tick == check.replayed.tick && check.recorded.score == check.replayed.score
+                    && check.recorded.pieces == check.replayed.pieces && check.recorded.lines == check.replayed.lines;
+    return check;
+}
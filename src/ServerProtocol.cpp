@@ -0,0 +1,120 @@
+#include "ServerProtocol.h"
+
+namespace ServerProtocol {
+
+static void put(std::vector<uint8_t>& out, uint32_t value, int count) {
+    for (int i = 0; i < count; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+static uint32_t get(const uint8_t* bytes, int count) {
+    uint32_t value = 0;
+    for (int i = 0; i < count; ++i) {
+        value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+void encodeNewGame(std::vector<uint8_t>& out, uint32_t seed) {
+    out.push_back(5);
+    out.push_back(NEW_GAME);
+    put(out, seed, 4);
+}
+
+void encodeInput(std::vector<uint8_t>& out, Input input, uint16_t ticks) {
+    out.push_back(4);
+    out.push_back(INPUT);
+    out.push_back(static_cast<uint8_t>(input));
+    put(out, ticks, 2);
+}
+
+void encodeUpdate(std::vector<uint8_t>& out, const GameCore& game, SessionView& sent) {
+    size_t start = out.size();
+    out.push_back(0); // Length, filled in below
+    out.push_back(UPDATE);
+
+    const Tetromino& piece = game.getCurrentTetromino();
+    sent.tick = static_cast<uint32_t>(game.getTick());
+    sent.piece = piece.getType();
+    sent.rotation = static_cast<uint8_t>(piece.getRotation());
+    sent.x = static_cast<int8_t>(piece.getX());
+    sent.y = static_cast<int8_t>(piece.getY());
+    sent.next = game.getNextTetromino().getType();
+    sent.held = game.getHeldTetromino().getType();
+
+    uint32_t changedRows = 0;
+    const Board& board = game.getBoard();
+    for (int y = 0; y < Board::HEIGHT; ++y) {
+        if (board.getRow(y) != sent.rows[y]) changedRows |= 1u << y;
+    }
+    bool scoreChanged = game.getScore() != sent.score || game.getLinesCleared() != sent.lines || game.getLevel() != sent.level;
+
+    sent.flags = (game.isGameOver() ? GAME_OVER : 0) | (game.isPaused() ? PAUSED : 0) | (game.canHold() ? CAN_HOLD : 0)
+                 | (changedRows ? ROWS_CHANGED : 0) | (scoreChanged ? SCORE_CHANGED : 0);
+
+    put(out, sent.tick, 4);
+    out.push_back(sent.flags);
+    out.push_back(static_cast<uint8_t>(sent.piece));
+    out.push_back(sent.rotation);
+    out.push_back(static_cast<uint8_t>(sent.x));
+    out.push_back(static_cast<uint8_t>(sent.y));
+    out.push_back(static_cast<uint8_t>(sent.next));
+    out.push_back(static_cast<uint8_t>(sent.held));
+
+    if (changedRows) {
+        put(out, changedRows, 4);
+        for (int y = 0; y < Board::HEIGHT; ++y) {
+            if (changedRows & (1u << y)) {
+                sent.rows[y] = board.getRow(y);
+                put(out, sent.rows[y], 2);
+            }
+        }
+    }
+    if (scoreChanged) {
+        sent.score = game.getScore();
+        sent.lines = static_cast<uint16_t>(game.getLinesCleared());
+        sent.level = static_cast<uint8_t>(game.getLevel());
+        put(out, static_cast<uint32_t>(sent.score), 4);
+        put(out, sent.lines, 2);
+        out.push_back(sent.level);
+    }
+    out[start] = static_cast<uint8_t>(out.size() - start - 1);
+}
+
+bool decodeUpdate(const uint8_t* body, size_t size, SessionView& view) {
+    const uint8_t* end = body + size;
+    if (size < 11) return false;
+
+    view.tick = get(body, 4);
+    view.flags = body[4];
+    view.piece = static_cast<TetrominoType>(body[5]);
+    view.rotation = body[6];
+    view.x = static_cast<int8_t>(body[7]);
+    view.y = static_cast<int8_t>(body[8]);
+    view.next = static_cast<TetrominoType>(body[9]);
+    view.held = static_cast<TetrominoType>(body[10]);
+    const uint8_t* cursor = body + 11;
+
+    if (view.flags & ROWS_CHANGED) {
+        if (end - cursor < 4) return false;
+        uint32_t changedRows = get(cursor, 4);
+        cursor += 4;
+        for (int y = 0; y < Board::HEIGHT; ++y) {
+            if ((changedRows & (1u << y)) == 0) continue;
+            if (end - cursor < 2) return false;
+            view.rows[y] = static_cast<Board::Row>(get(cursor, 2));
+            cursor += 2;
+        }
+    }
+    if (view.flags & SCORE_CHANGED) {
+        if (end - cursor < 7) return false;
+        view.score = static_cast<int32_t>(get(cursor, 4));
+        view.lines = static_cast<uint16_t>(get(cursor + 4, 2));
+        view.level = cursor[6];
+        cursor += 7;
+    }
+    return cursor == end;
+}
+
+}
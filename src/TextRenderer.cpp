@@ -0,0 +1,154 @@
+#include "TextRenderer.h"
+#include <cstdio>
+#include <iostream>
+
+TextRenderer::TextRenderer() : font(nullptr), owner(nullptr), atlas(nullptr), glyphs() {}
+
+TextRenderer::~TextRenderer() {
+    clear();
+}
+
+void TextRenderer::setFont(TTF_Font* newFont) {
+    clear();
+    font = newFont;
+}
+
+void TextRenderer::clear() {
+    if (atlas) {
+        SDL_DestroyTexture(atlas);
+        atlas = nullptr;
+    }
+    for (Label& label : labels) {
+        SDL_DestroyTexture(label.texture);
+    }
+    labels.clear();
+    owner = nullptr;
+}
+
+bool TextRenderer::prepare(SDL_Renderer* renderer) {
+    if (font == nullptr) return false; // Don't render if font not loaded
+
+    if (renderer != owner) {
+        clear();
+        owner = renderer;
+        buildAtlas();
+    }
+    return true;
+}
+
+bool TextRenderer::buildAtlas() {
+    const int glyphCount = LAST_GLYPH - FIRST_GLYPH + 1;
+    const SDL_Color white = {255, 255, 255, 255}; // Glyphs are tinted with a color mod when drawn
+    int lineHeight = TTF_FontHeight(font);
+
+    // Render every glyph and lay them out in rows
+    SDL_Surface* surfaces[glyphCount] = {};
+    int penX = 0, penY = 0;
+    for (int i = 0; i < glyphCount; ++i) {
+        Uint16 ch = static_cast<Uint16>(FIRST_GLYPH + i);
+        int advance = 0;
+        TTF_GlyphMetrics(font, ch, nullptr, nullptr, nullptr, nullptr, &advance);
+        surfaces[i] = TTF_RenderGlyph_Solid(font, ch, white);
+
+        int width = surfaces[i] ? surfaces[i]->w : 0;
+        int height = surfaces[i] ? surfaces[i]->h : 0;
+        if (penX + width > ATLAS_WIDTH) {
+            penX = 0;
+            penY += lineHeight;
+        }
+        glyphs[i] = {{penX, penY, width, height}, advance};
+        penX += width;
+    }
+
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, penY + lineHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (sheet == nullptr) {
+        std::cerr << "Unable to create glyph atlas surface! SDL Error: " << SDL_GetError() << std::endl;
+    } else {
+        SDL_FillRect(sheet, nullptr, 0); // Transparent background
+        for (int i = 0; i < glyphCount; ++i) {
+            if (surfaces[i]) {
+                SDL_Rect destination = glyphs[i].source;
+                SDL_BlitSurface(surfaces[i], nullptr, sheet, &destination);
+            }
+        }
+        atlas = SDL_CreateTextureFromSurface(owner, sheet);
+        if (atlas == nullptr) {
+            std::cerr << "Unable to create glyph atlas texture! SDL Error: " << SDL_GetError() << std::endl;
+        } else {
+            SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+        }
+        SDL_FreeSurface(sheet);
+    }
+
+    for (SDL_Surface* surface : surfaces) {
+        if (surface) SDL_FreeSurface(surface);
+    }
+    return atlas != nullptr;
+}
+
+const TextRenderer::Label* TextRenderer::findLabel(const char* text, SDL_Color color) {
+    for (const Label& label : labels) {
+        if (label.color.r == color.r && label.color.g == color.g && label.color.b == color.b && label.color.a == color.a
+            && label.text == text) {
+            return &label;
+        }
+    }
+
+    // First use: render the string once and keep the texture
+    SDL_Surface* textSurface = TTF_RenderText_Solid(font, text, color);
+    if (textSurface == nullptr) {
+        std::cerr << "Unable to render text surface! SDL_ttf Error: " << TTF_GetError() << std::endl;
+        return nullptr;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(owner, textSurface);
+    int width = textSurface->w, height = textSurface->h;
+    SDL_FreeSurface(textSurface);
+    if (texture == nullptr) {
+        std::cerr << "Unable to create texture from rendered text! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    labels.push_back({text, color, texture, width, height});
+    return &labels.back();
+}
+
+void TextRenderer::drawLabel(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color) {
+    if (!prepare(renderer)) return;
+
+    const Label* label = findLabel(text, color);
+    if (label) {
+        SDL_Rect renderQuad = {x, y, label->width, label->height};
+        SDL_RenderCopy(renderer, label->texture, nullptr, &renderQuad);
+    }
+}
+
+int TextRenderer::labelWidth(SDL_Renderer* renderer, const char* text, SDL_Color color) {
+    if (!prepare(renderer)) return 0;
+
+    const Label* label = findLabel(text, color);
+    return label ? label->width : 0;
+}
+
+void TextRenderer::drawText(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color) {
+    if (!prepare(renderer) || atlas == nullptr) return;
+
+    SDL_SetTextureColorMod(atlas, color.r, color.g, color.b);
+    int penX = x;
+    for (const char* ch = text; *ch; ++ch) {
+        int index = static_cast<unsigned char>(*ch) - FIRST_GLYPH;
+        if (index < 0 || index > LAST_GLYPH - FIRST_GLYPH) continue; // Not in the atlas
+
+        const Glyph& glyph = glyphs[index];
+        if (glyph.source.w > 0) {
+            SDL_Rect renderQuad = {penX, y, glyph.source.w, glyph.source.h};
+            SDL_RenderCopy(renderer, atlas, &glyph.source, &renderQuad);
+        }
+        penX += glyph.advance;
+    }
+}
+
+void TextRenderer::drawNumber(SDL_Renderer* renderer, int value, int x, int y, SDL_Color color) {
+    char digits[16];
+    std::snprintf(digits, sizeof(digits), "%d", value);
+    drawText(renderer, digits, x, y, color);
+}
@@ -0,0 +1,34 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    size_t wanted = megabytes * 1024 * 1024 / sizeof(Slot);
+    size_t count = 1;
+    while (count * 2 <= wanted) {
+        count *= 2;
+    }
+    slots.reset(new Slot[count]);
+    mask = count - 1;
+    clear();
+}
+
+bool TranspositionTable::probe(uint64_t key, uint64_t& value) const {
+    // Low bits pick the slot; the check covers all 64
+    const Slot& slot = slots[key & mask];
+    uint64_t stored = slot.value.load(std::memory_order_relaxed);
+    if ((slot.check.load(std::memory_order_relaxed) ^ stored) != key) return false;
+    value = stored;
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, uint64_t value) {
+    Slot& slot = slots[key & mask];
+    slot.check.store(key ^ value, std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask; ++i) {
+        slots[i].check.store(0, std::memory_order_relaxed);
+        slots[i].value.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,192 @@
+#include "VideoExporter.h"
+#include "FrameRasterizer.h"
+#include "RenderSnapshot.h"
+#include "Replay.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char FRAME_HEADER[] = "FRAME\n";
+const size_t FRAME_HEADER_SIZE = sizeof(FRAME_HEADER) - 1;
+
+bool samePiece(const Tetromino& a, const Tetromino& b) {
+    return a.getType() == b.getType() && a.getRotation() == b.getRotation() && a.getX() == b.getX() && a.getY() == b.getY();
+}
+
+// Whether two snapshots draw the same picture; most ticks change nothing visible
+bool looksSame(const RenderSnapshot& a, const RenderSnapshot& b) {
+    return a.boardRevision == b.boardRevision && samePiece(a.current, b.current) && samePiece(a.next, b.next) && samePiece(a.held, b.held)
+           && a.score == b.score && a.paused == b.paused && a.gameOver == b.gameOver;
+}
+
+// Frames go through a ring of slots in order: queued by the simulating thread, drawn and encoded by
+// whichever worker claims them, then written by the writer thread in queue order. A full ring
+// blocks the simulation, so memory stays bounded however far ahead it could run.
+class ExportPipeline {
+public:
+    ExportPipeline(const FrameRasterizer& rasterizer, std::FILE* file, unsigned threads)
+        : rasterizer(rasterizer), file(file), slots(threads + 4), queued(0), claimed(0), written(0), stopping(false), failed(false) {
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back(&ExportPipeline::workerLoop, this);
+        }
+        writer = std::thread(&ExportPipeline::writerLoop, this);
+    }
+
+    ~ExportPipeline() { finish(); }
+
+    // Blocks while every slot is in flight; false once a write has failed
+    bool push(const RenderSnapshot& state, bool repeat) {
+        std::unique_lock<std::mutex> lock(mutex);
+        slotFree.wait(lock, [this] { return queued - written < slots.size(); });
+        Slot& slot = slots[queued % slots.size()];
+        slot.repeat = repeat;
+        if (!repeat) slot.state = state;
+        ++queued;
+        frameQueued.notify_one();
+        return !failed;
+    }
+
+    // Waits until every queued frame is written; false if a write failed
+    bool finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) return !failed;
+            stopping = true;
+        }
+        frameQueued.notify_all();
+        frameReady.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        writer.join();
+        return !failed;
+    }
+
+private:
+    struct Slot {
+        RenderSnapshot state;
+        bool repeat = false; // Same picture as the frame before; not drawn
+        bool ready = false;  // Encoded, waiting for the writer
+        std::vector<uint8_t> frame; // FRAME header and YUV planes
+    };
+
+    const FrameRasterizer& rasterizer;
+    std::FILE* file;
+    std::vector<Slot> slots;
+    uint64_t queued, claimed, written; // Frame counts; frame n lives in slot n % slots.size()
+    bool stopping;
+    bool failed;
+
+    std::mutex mutex;
+    std::condition_variable frameQueued; // Workers wait for frames to draw
+    std::condition_variable frameReady;  // The writer waits for the next frame in order
+    std::condition_variable slotFree;    // The simulation waits for room in the ring
+    std::vector<std::thread> workers;
+    std::thread writer;
+
+    void workerLoop() {
+        std::vector<uint32_t> pixels(static_cast<size_t>(rasterizer.getWidth()) * rasterizer.getHeight());
+        size_t frameSize = FRAME_HEADER_SIZE + FrameRasterizer::yuv420Size(rasterizer.getWidth(), rasterizer.getHeight());
+
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            frameQueued.wait(lock, [this] { return claimed < queued || stopping; });
+            if (claimed == queued) return; // Stopping with nothing left
+            Slot& slot = slots[claimed++ % slots.size()];
+            if (!slot.repeat) {
+                lock.unlock();
+                rasterizer.draw(slot.state, pixels.data());
+                slot.frame.resize(frameSize);
+                std::copy(FRAME_HEADER, FRAME_HEADER + FRAME_HEADER_SIZE, slot.frame.begin());
+                FrameRasterizer::toYuv420(pixels.data(), rasterizer.getWidth(), rasterizer.getHeight(), slot.frame.data() + FRAME_HEADER_SIZE);
+                lock.lock();
+            }
+            slot.ready = true;
+            frameReady.notify_one();
+        }
+    }
+
+    void writerLoop() {
+        std::vector<uint8_t> previous; // Last frame drawn, written again for repeats
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            frameReady.wait(lock, [this] { return (written < queued && slots[written % slots.size()].ready) || (stopping && written == queued); });
+            if (written == queued) return;
+            Slot& slot = slots[written % slots.size()];
+            lock.unlock();
+            if (!slot.repeat) std::swap(slot.frame, previous); // The slot takes the old buffer to encode into next
+            bool ok = std::fwrite(previous.data(), 1, previous.size(), file) == previous.size();
+            lock.lock();
+            failed = failed || !ok;
+            slot.ready = false;
+            ++written;
+            slotFree.notify_one();
+        }
+    }
+};
+
+} // namespace
+
+ExportResult exportReplay(const std::string& replayPath, const std::string& outputPath, const ExportOptions& options) {
+    ExportResult result;
+    if (options.width <= 0 || options.height <= 0) {
+        std::cerr << "Invalid video size " << options.width << "x" << options.height << std::endl;
+        return result;
+    }
+
+    ReplayReader reader;
+    if (!reader.open(replayPath)) return result;
+
+    bool toStdout = outputPath == "-";
+    std::FILE* file = toStdout ? stdout : std::fopen(outputPath.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Unable to open " << outputPath << " for writing" << std::endl;
+        return result;
+    }
+
+    FrameRasterizer rasterizer(options.width, options.height, options.cellSize);
+    uint32_t ticksPerFrame = std::max(1u, options.ticksPerFrame);
+    unsigned threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::fprintf(file, "YUV4MPEG2 W%d H%d F%u:%u Ip A1:1 C420jpeg\n", options.width, options.height, GameCore::TICKS_PER_SECOND, ticksPerFrame);
+
+    GameCore game;
+    ReplayPlayer player(reader);
+    player.start(game);
+    if (options.startTick > 0) {
+        player.advance(game, options.startTick);
+    }
+    uint64_t firstTick = game.getTick();
+
+    ExportPipeline pipeline(rasterizer, file, threads);
+    RenderSnapshot state, drawn;
+    for (;;) {
+        state.capture(game);
+        bool repeat = result.frames > 0 && looksSame(state, drawn);
+        if (!pipeline.push(state, repeat)) break;
+        if (!repeat) {
+            drawn = state;
+            ++result.drawn;
+        }
+        ++result.frames;
+        if (player.isFinished() || (options.maxFrames > 0 && result.frames >= options.maxFrames)) break;
+        player.advance(game, ticksPerFrame);
+    }
+    result.ok = pipeline.finish();
+    result.ticks = game.getTick() - firstTick;
+
+    if (toStdout) {
+        result.ok = std::fflush(file) == 0 && result.ok;
+    } else {
+        result.ok = std::fclose(file) == 0 && result.ok;
+    }
+    if (!result.ok) {
+        std::cerr << "Unable to write " << outputPath << std::endl;
+    }
+    return result;
+}
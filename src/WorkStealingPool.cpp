@@ -0,0 +1,135 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount)
+    : queued(0), pending(0), steals(0), nextQueue(0), stopping(false), batchState(0), batchLeft(0), batchFn(nullptr) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> job) {
+    unsigned index = nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        // Count the job before it becomes visible so the counter never underflows
+        std::lock_guard<std::mutex> lock(idleMutex);
+        queued.fetch_add(1, std::memory_order_release);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->jobs.push_back(std::move(job));
+    }
+    workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(idleMutex);
+    allDone.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+}
+
+void WorkStealingPool::run(int count, const std::function<void(int)>& fn) {
+    if (count <= 0) return;
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        batchFn = &fn;
+        batchLeft.store(count, std::memory_order_relaxed);
+        batchState.store(static_cast<uint64_t>(count) << 32, std::memory_order_release);
+    }
+    workAvailable.notify_all();
+
+    runBatch();
+    std::unique_lock<std::mutex> lock(idleMutex);
+    allDone.wait(lock, [this] { return batchLeft.load(std::memory_order_acquire) == 0; });
+}
+
+bool WorkStealingPool::batchWaiting() const {
+    uint64_t state = batchState.load(std::memory_order_acquire);
+    return (state & 0xFFFFFFFFu) < (state >> 32);
+}
+
+bool WorkStealingPool::runBatch() {
+    bool ran = false;
+    while (batchWaiting()) {
+        uint64_t state = batchState.fetch_add(1, std::memory_order_acq_rel);
+        int item = static_cast<int>(state & 0xFFFFFFFFu);
+        if (item >= static_cast<int>(state >> 32)) break; // Another thread took the last one
+
+        // The item's batch cannot end before it finishes, so batchFn is still this batch's
+        (*batchFn)(item);
+        ran = true;
+        if (batchLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            allDone.notify_all();
+        }
+    }
+    return ran;
+}
+
+bool WorkStealingPool::popLocal(unsigned index, std::function<void()>& job) {
+    WorkerQueue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+
+    job = std::move(queue.jobs.back()); // Newest first: its data is most likely still in cache
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned index, std::function<void()>& job) {
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkerQueue& victim = *queues[(index + offset) % queues.size()];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.jobs.empty()) continue;
+
+        job = std::move(victim.jobs.front()); // Oldest first: leaves the victim its hot end
+        victim.jobs.pop_front();
+        steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(unsigned index) {
+    std::function<void()> job;
+    while (true) {
+        if (popLocal(index, job) || steal(index, job)) {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            job();
+            job = nullptr;
+
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+        if (runBatch()) continue;
+
+        // Nothing found: sleep until more work is queued. A failed try_lock in steal()
+        // can miss a job, so re-check the count instead of trusting the scan.
+        std::unique_lock<std::mutex> lock(idleMutex);
+        workAvailable.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0 || batchWaiting(); });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,658 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "Bot.h"
+#include "FeatureBatch.h"
+#include "FrameRasterizer.h"
+#include "GameCore.h"
+#include "MoveGenerator.h"
+#include "RenderSnapshot.h"
+#include "Tetromino.h"
+#include "TranspositionTable.h"
+#include "TripleBuffer.h"
+
+#ifdef TETROMINO_BENCH_RENDER
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "Game.h"
+#endif
+
+// Micro- and macro-benchmarks for the engine hot paths. Every input is built from fixed
+// seeds, so runs on the same machine measure the same work. Results can be written as JSON
+// and compared against a previous run's file.
+
+struct BenchOptions {
+    std::string filter;       // Only run benchmarks whose name contains this
+    std::string jsonPath;     // Write results here
+    std::string baselinePath; // Compare against results written by an earlier run
+    double minTimeMs = 50.0;  // Per sample
+    int repetitions = 5;      // Samples per benchmark; the median is reported
+    double threshold = 5.0;   // Percent slowdown that counts as a regression
+    bool check = false;       // Cross-check generatePlacements against a plain search instead of timing
+};
+
+struct Benchmark {
+    std::string name;
+    std::function<void(uint64_t iterations)> run; // Performs the operation iterations times
+};
+
+struct BenchResult {
+    std::string name;
+    double nsPerOp; // Median over the samples
+    double minNs;
+    double maxNs;
+    uint64_t iterations; // Per sample
+};
+
+// Keeps the compiler from optimizing away work whose result is otherwise unused
+template <typename T>
+static inline void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Drops random pieces straight down on a board of any geometry, clearing lines and starting
+// over when a piece no longer fits; measures the placement path of the board variants
+template <typename BoardType>
+static void addDropBenchmark(std::vector<Benchmark>& benchmarks, const std::string& name) {
+    benchmarks.push_back({name, [](uint64_t iterations) {
+        BoardType board;
+        std::mt19937 rng(1);
+        for (uint64_t i = 0; i < iterations; ++i) {
+            Tetromino piece(static_cast<TetrominoType>(rng() % 7));
+            piece.move(static_cast<int>(rng() % (BoardType::WIDTH - 3)), -BoardType::HIDDEN);
+            if (board.isCollision(piece)) {
+                board.reset();
+                continue;
+            }
+            piece.move(0, board.dropDistance(piece));
+            board.addTetromino(piece);
+            keep(board.clearLines());
+        }
+    }});
+}
+
+static double timeRun(const Benchmark& benchmark, uint64_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    benchmark.run(iterations);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static BenchResult measure(const Benchmark& benchmark, const BenchOptions& options) {
+    // Grow the iteration count until one sample takes about minTimeMs
+    double targetNs = options.minTimeMs * 1e6;
+    uint64_t iterations = 1;
+    double elapsed = timeRun(benchmark, iterations);
+    while (elapsed < targetNs / 10) {
+        iterations *= 10;
+        elapsed = timeRun(benchmark, iterations);
+    }
+    iterations = std::max<uint64_t>(1, static_cast<uint64_t>(iterations * targetNs / std::max(elapsed, 1.0)));
+
+    std::vector<double> samples;
+    for (int i = 0; i < options.repetitions; ++i) {
+        samples.push_back(timeRun(benchmark, iterations) / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    return {benchmark.name, samples[samples.size() / 2], samples.front(), samples.back(), iterations};
+}
+
+// Boards and pieces used by the benchmarks
+
+static const Color GARBAGE_COLOR = {128, 128, 128, 255};
+
+// Rows of garbage with random holes, never in column 0
+static Board garbageBoard(int rows, uint32_t seed) {
+    std::mt19937 rng(seed);
+    Board board;
+    for (int i = 0; i < rows; ++i) {
+        board.addGarbage(1, 1 + static_cast<int>(rng() % (Board::WIDTH - 1)), GARBAGE_COLOR);
+    }
+    return board;
+}
+
+// Garbage stack whose top lines rows become full when a vertical I is dropped into column 0
+static Board boardWithFullLines(int lines, int garbageRows) {
+    std::mt19937 rng(7);
+    Board board;
+    for (int i = 0; i < lines; ++i) {
+        board.addGarbage(1, 0, GARBAGE_COLOR);
+    }
+    for (int i = 0; i < garbageRows; ++i) {
+        board.addGarbage(1, 1 + static_cast<int>(rng() % (Board::WIDTH - 1)), GARBAGE_COLOR);
+    }
+    if (lines > 0) {
+        Tetromino filler(TetrominoType::I, 1, -2, 0); // Vertical I occupies box column 2
+        filler.move(0, board.dropDistance(filler));
+        board.addTetromino(filler);
+    }
+    return board;
+}
+
+// Valid (non-colliding) pieces spread over the board, for collision and ghost lookups
+static std::vector<Tetromino> samplePieces(const Board& board, size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Tetromino> pieces;
+    while (pieces.size() < count) {
+        Tetromino piece(static_cast<TetrominoType>(rng() % 7), static_cast<int>(rng() % 4),
+                        static_cast<int>(rng() % 12) - 2, static_cast<int>(rng() % Board::HEIGHT) - 2);
+        if (!board.isCollision(piece)) {
+            pieces.push_back(piece);
+        }
+    }
+    return pieces;
+}
+
+// The ghost search Game::render used before drop distances were cached
+static int scanDropDistance(const Board& board, Tetromino piece) {
+    int distance = 0;
+    while (true) {
+        Tetromino next = piece;
+        next.move(0, 1);
+        if (board.isCollision(next)) return distance;
+        piece = next;
+        distance++;
+    }
+}
+
+// Board cells a piece covers, sorted and packed one byte each, so equal cells give equal keys
+static uint32_t cellsKey(const Tetromino& piece) {
+    const ShapeData& shape = piece.getShape();
+    uint8_t cells[4];
+    for (int c = 0; c < 4; ++c) {
+        cells[c] = static_cast<uint8_t>((piece.getY() + shape.cellY[c] + PlacementList::ROWS_ABOVE) * Board::WIDTH + piece.getX() + shape.cellX[c]);
+    }
+    std::sort(cells, cells + 4);
+    return static_cast<uint32_t>(cells[0]) | cells[1] << 8 | cells[2] << 16 | static_cast<uint32_t>(cells[3]) << 24;
+}
+
+// Reference for generatePlacements: breadth-first search over single piece positions with
+// the moves GameCore allows, collecting those that cannot move down
+static std::set<uint32_t> searchPlacements(const Board& board, const Tetromino& start) {
+    std::set<uint32_t> resting;
+    if (board.isCollision(start)) return resting;
+
+    const int ROWS = PlacementList::ROWS_ABOVE + Board::HEIGHT;
+    const int COLUMNS = Board::WIDTH + 8; // Boxes hang up to 3 columns past the left wall
+    std::vector<bool> visited(4 * ROWS * COLUMNS);
+    auto visit = [&](const Tetromino& piece) {
+        size_t index = (piece.getRotation() * ROWS + piece.getY() + PlacementList::ROWS_ABOVE) * COLUMNS + piece.getX() + 4;
+        if (visited[index]) return false;
+        visited[index] = true;
+        return true;
+    };
+
+    std::vector<Tetromino> queue = {start};
+    visit(start);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        Tetromino current = queue[head];
+
+        Tetromino moves[4] = {current, current, current, current};
+        moves[0].move(-1, 0);
+        moves[1].move(1, 0);
+        moves[2].move(0, 1);
+        moves[3].rotate();
+        if (board.isCollision(moves[3])) { // Right-then-left kick, as in GameCore::rotateTetromino
+            moves[3].move(1, 0);
+            if (board.isCollision(moves[3])) moves[3].move(-2, 0);
+        }
+        if (board.isCollision(moves[2])) resting.insert(cellsKey(current));
+        for (const Tetromino& next : moves) {
+            if (!board.isCollision(next) && visit(next)) queue.push_back(next);
+        }
+    }
+    return resting;
+}
+
+// Compares generatePlacements with searchPlacements on garbage stacks with random pieces
+// dropped on top, which leave overhangs to tuck under. Returns the number of mismatches.
+static int checkPlacements() {
+    const int BOARDS = 500;
+    int mismatches = 0, largest = 0;
+    long placementCount = 0;
+    PlacementList placements;
+    for (int i = 0; i < BOARDS; ++i) {
+        std::mt19937 rng(static_cast<uint32_t>(i));
+        Board board = garbageBoard(i % 12, static_cast<uint32_t>(i));
+        int drops = static_cast<int>(rng() % 30);
+        for (int d = 0; d < drops; ++d) {
+            Tetromino piece(static_cast<TetrominoType>(rng() % 7), static_cast<int>(rng() % 4), static_cast<int>(rng() % 10) - 1, 0);
+            if (board.isCollision(piece)) continue;
+            piece.move(0, board.dropDistance(piece));
+            board.addTetromino(piece);
+            board.clearLines();
+        }
+
+        for (int type = 0; type < 7; ++type) {
+            Tetromino start = GameCore::atSpawn(Tetromino(static_cast<TetrominoType>(type)));
+            generatePlacements(board, start, placements);
+            std::set<uint32_t> generated;
+            for (const Placement& placement : placements) {
+                generated.insert(cellsKey(placement.toTetromino()));
+            }
+            bool duplicates = generated.size() != static_cast<size_t>(placements.size());
+            if (duplicates || generated != searchPlacements(board, start)) {
+                std::cerr << "Board " << i << ", piece " << type << ": generatePlacements found " << placements.size()
+                          << (duplicates ? " (with duplicates)" : "") << ", the search " << searchPlacements(board, start).size() << std::endl;
+                mismatches++;
+            }
+            placementCount += placements.size();
+            largest = std::max(largest, placements.size());
+        }
+    }
+    std::cout << "movegen: " << BOARDS << " boards x 7 pieces, " << placementCount << " placements (at most " << largest
+              << " of " << PlacementList::CAPACITY << "), " << mismatches << " mismatch(es)" << std::endl;
+    return mismatches;
+}
+
+static std::vector<Benchmark> coreBenchmarks() {
+    std::vector<Benchmark> benchmarks;
+
+    Board empty;
+    Board stacked = garbageBoard(12, 1);
+    std::vector<Tetromino> emptyPieces = samplePieces(empty, 256, 2);
+    std::vector<Tetromino> stackedPieces = samplePieces(stacked, 256, 3);
+
+    benchmarks.push_back({"board/isCollision/empty", [=](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            keep(empty.isCollision(emptyPieces[i & 255]));
+        }
+    }});
+    benchmarks.push_back({"board/isCollision/stacked", [=](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            Tetromino piece = stackedPieces[i & 255];
+            piece.move(0, 1); // About half of these collide
+            keep(stacked.isCollision(piece));
+        }
+    }});
+    benchmarks.push_back({"board/addTetromino", [=](uint64_t iterations) {
+        Board board = stacked;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            board.addTetromino(stackedPieces[i & 255]);
+            keep(board);
+        }
+    }});
+    benchmarks.push_back({"board/copy", [=](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            Board board = stacked; // Baseline for the clearLines benchmarks, which copy first
+            keep(board);
+        }
+    }});
+    for (int lines = 0; lines <= 4; ++lines) {
+        Board full = boardWithFullLines(lines, 8);
+        benchmarks.push_back({"board/clearLines/" + std::to_string(lines), [=](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+                Board board = full;
+                keep(board.clearLines());
+            }
+        }});
+    }
+    Board heavy = boardWithFullLines(4, 15);
+    benchmarks.push_back({"board/clearLines/garbage", [=](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            Board board = heavy;
+            keep(board.clearLines());
+        }
+    }});
+    addDropBenchmark<Board>(benchmarks, "board/drop/10x20");
+    addDropBenchmark<BasicBoard<16, 24, 4>>(benchmarks, "board/drop/16x24+4");
+    addDropBenchmark<BasicBoard<64, 32, 8>>(benchmarks, "board/drop/64x32+8");
+
+    benchmarks.push_back({"tetromino/rotate", [=](uint64_t iterations) {
+        Tetromino piece(TetrominoType::T, 0, 3, 0);
+        for (uint64_t i = 0; i < iterations; ++i) {
+            piece.rotate();
+            keep(piece);
+        }
+    }});
+
+    benchmarks.push_back({"ghost/scan", [=](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            keep(scanDropDistance(stacked, stackedPieces[i & 255]));
+        }
+    }});
+    benchmarks.push_back({"ghost/profile", [=](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            keep(stacked.dropDistance(stackedPieces[i & 255]));
+        }
+    }});
+    benchmarks.push_back({"ghost/cached", [=](uint64_t iterations) {
+        GameCore game(1);
+        for (uint64_t i = 0; i < iterations; ++i) {
+            keep(game.getDropDistance());
+        }
+    }});
+
+    // spawnTetromino is private to GameCore; a hard drop measures lock, line clear and spawn together
+    benchmarks.push_back({"core/hardDrop", [=](uint64_t iterations) {
+        GameCore game(1);
+        std::mt19937 rng(1);
+        for (uint64_t i = 0; i < iterations; ++i) {
+            if (game.isGameOver()) game.reset(static_cast<uint32_t>(i));
+            game.step(static_cast<Input>(rng() & 3), 0); // Left, right or both, to spread the stack
+            game.step(Input::HardDrop, 0);
+        }
+        keep(game.getScore());
+    }});
+    benchmarks.push_back({"core/idleTicks/3600", [=](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            GameCore game(static_cast<uint32_t>(i));
+            for (int tick = 0; tick < 3600; ++tick) { // One minute of gravity, one tick at a time
+                game.step(Input::None);
+            }
+            keep(game.getTick());
+        }
+    }});
+
+    // What the simulation thread pays per published frame, and the window thread per frame taken
+    benchmarks.push_back({"core/snapshot/publish", [=](uint64_t iterations) {
+        GameCore game(1);
+        game.addGarbage(12, 3, TetrominoTables::COLORS[0]);
+        std::unique_ptr<TripleBuffer<RenderSnapshot>> snapshots(new TripleBuffer<RenderSnapshot>());
+        for (uint64_t i = 0; i < iterations; ++i) {
+            snapshots->back().capture(game);
+            snapshots->publish();
+            keep(snapshots->acquire());
+        }
+        keep(snapshots->front().score);
+    }});
+
+    // Headless video export at 1080p: rasterizing a frame, then converting it for the .y4m file
+    benchmarks.push_back({"export/draw/1080p", [=](uint64_t iterations) {
+        GameCore game(1);
+        game.addGarbage(12, 3, TetrominoTables::COLORS[0]);
+        RenderSnapshot state;
+        state.capture(game);
+        FrameRasterizer rasterizer(1920, 1080);
+        std::vector<uint32_t> pixels(1920 * 1080);
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rasterizer.draw(state, pixels.data());
+            keep(pixels[i % pixels.size()]);
+        }
+    }});
+    benchmarks.push_back({"export/yuv420/1080p", [=](uint64_t iterations) {
+        GameCore game(1);
+        game.addGarbage(12, 3, TetrominoTables::COLORS[0]);
+        RenderSnapshot state;
+        state.capture(game);
+        FrameRasterizer rasterizer(1920, 1080);
+        std::vector<uint32_t> pixels(1920 * 1080);
+        rasterizer.draw(state, pixels.data());
+        std::vector<uint8_t> frame(FrameRasterizer::yuv420Size(1920, 1080));
+        for (uint64_t i = 0; i < iterations; ++i) {
+            FrameRasterizer::toYuv420(pixels.data(), 1920, 1080, frame.data());
+            keep(frame[i % frame.size()]);
+        }
+    }});
+
+    benchmarks.push_back({"movegen/generatePlacements/stacked", [=](uint64_t iterations) {
+        PlacementList placements;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            generatePlacements(stacked, static_cast<TetrominoType>(i % 7), placements);
+            keep(placements.size());
+        }
+    }});
+    // Features of every placement of every piece on the stacked board, as one bot search depth sees them
+    struct PlacedBoards {
+        std::vector<Board> boards;
+        std::vector<const Board*> pointers;
+    };
+    auto placed = std::make_shared<PlacedBoards>();
+    for (int type = 0; type < 7; ++type) {
+        PlacementList placements;
+        generatePlacements(stacked, static_cast<TetrominoType>(type), placements);
+        for (const Placement& placement : placements) {
+            placed->boards.push_back(stacked);
+            placed->boards.back().addTetromino(placement.toTetromino());
+        }
+    }
+    for (const Board& board : placed->boards) {
+        placed->pointers.push_back(&board);
+    }
+    benchmarks.push_back({"bot/features/each", [=](uint64_t iterations) {
+        int total = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            for (const Board& board : placed->boards) {
+                total += computeFeatures(board).holes;
+            }
+        }
+        keep(total);
+    }});
+    auto addFeatureBatchBenchmark = [&](const std::string& name, void (*kernel)(const Board* const*, size_t, const FeatureArrays&)) {
+        benchmarks.push_back({name, [=](uint64_t iterations) {
+            size_t count = placed->pointers.size();
+            std::vector<int16_t> columns(count * 7);
+            FeatureArrays out = {nullptr, &columns[0], &columns[count], &columns[2 * count], &columns[3 * count],
+                                 &columns[4 * count], &columns[5 * count], &columns[6 * count]};
+            for (uint64_t i = 0; i < iterations; ++i) {
+                kernel(placed->pointers.data(), count, out);
+                keep(columns[i % columns.size()]);
+            }
+        }});
+    };
+    addFeatureBatchBenchmark("bot/features/batch/scalar", computeFeatureBatchScalar);
+    addFeatureBatchBenchmark(std::string("bot/features/batch/") + featureBatchKernel(), computeFeatureBatch);
+
+    benchmarks.push_back({"bot/think", [=](uint64_t iterations) {
+        BotConfig config;
+        config.timeBudgetMicros = 1000000; // Never cut short, so every think does the same work
+        Bot bot(config);
+        GameCore game(1);
+        for (uint64_t i = 0; i < iterations; ++i) {
+            keep(bot.think(game).score);
+        }
+    }});
+    // One piece per iteration of a bot game, without and with a feature cache; positions recur
+    // across moves, so the cache carries over from one think to the next
+    std::shared_ptr<TranspositionTable> table = std::make_shared<TranspositionTable>(4);
+    for (bool cached : {false, true}) {
+        benchmarks.push_back({cached ? "bot/play/table" : "bot/play", [=](uint64_t iterations) {
+            BotConfig config;
+            config.timeBudgetMicros = 1000000;
+            config.table = cached ? table.get() : nullptr;
+            Bot bot(config);
+            GameCore game(1);
+            for (uint64_t i = 0; i < iterations; ++i) {
+                if (game.isGameOver()) game.reset(static_cast<uint32_t>(i));
+                int pieces = game.getPiecesPlaced();
+                while (game.getPiecesPlaced() == pieces && !game.isGameOver()) {
+                    game.step(bot.nextInput(game), 0);
+                }
+            }
+            keep(game.getScore());
+        }});
+    }
+
+    return benchmarks;
+}
+
+#ifdef TETROMINO_BENCH_RENDER
+// Full Game::render into an offscreen software renderer, on a nearly full board
+struct RenderPath {
+    const char* name;
+    bool cached;
+    bool batched;
+};
+
+static const RenderPath RENDER_PATHS[] = {{"render/game/1080p", true, true}, {"render/game/1080p/uncached", false, true},
+                                          {"render/game/1080p/per-cell", false, false}};
+
+static void addRenderBenchmarks(std::vector<Benchmark>& benchmarks, const std::string& filter) {
+    // Skip SDL setup when every render path is filtered out
+    bool wanted = false;
+    for (const RenderPath& path : RENDER_PATHS) {
+        wanted = wanted || std::string(path.name).find(filter) != std::string::npos;
+    }
+    if (!wanted) return;
+
+    static SDL_Surface* surface = nullptr;
+    static SDL_Renderer* renderer = nullptr;
+    static Game* game = nullptr;
+    if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() == -1) {
+        std::cerr << "SDL could not initialize; skipping render benchmarks. SDL_Error: " << SDL_GetError() << std::endl;
+        return;
+    }
+    surface = SDL_CreateRGBSurfaceWithFormat(0, 1920, 1080, 32, SDL_PIXELFORMAT_RGBA32);
+    renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    if (renderer == nullptr) {
+        std::cerr << "Unable to create offscreen renderer; skipping render benchmarks. SDL_Error: " << SDL_GetError() << std::endl;
+        return;
+    }
+    game = new Game(1); // Lives until exit, like the SDL state it uses
+    game->waitForAssets();
+    for (int y = 0; y < Board::HEIGHT - 4; ++y) {
+        game->addGarbage(1, y % Board::WIDTH, TetrominoTables::COLORS[y % (TetrominoTables::TYPE_COUNT - 1)]);
+    }
+
+    for (RenderPath path : RENDER_PATHS) {
+        benchmarks.push_back({path.name, [path](uint64_t iterations) {
+            game->setCachedBoard(path.cached);
+            game->setBatchedRendering(path.batched);
+            int cellSize = std::min(1920 / Board::WIDTH, 1080 / Board::HEIGHT);
+            for (uint64_t i = 0; i < iterations; ++i) {
+                SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+                SDL_RenderClear(renderer);
+                game->render(renderer, cellSize);
+            }
+        }});
+    }
+}
+#endif
+
+static void writeJson(std::ostream& out, const std::vector<BenchResult>& results) {
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        out << "    {\"name\": \"" << result.name << "\", \"ns_per_op\": " << result.nsPerOp << ", \"min_ns\": " << result.minNs
+            << ", \"max_ns\": " << result.maxNs << ", \"iterations\": " << result.iterations << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Reads the name and ns_per_op of each entry in a file written by writeJson
+static bool readBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Unable to open baseline " << path << std::endl;
+        return false;
+    }
+    std::stringstream contents;
+    contents << in.rdbuf();
+    std::string text = contents.str();
+
+    const std::string nameKey = "\"name\": \"";
+    const std::string timeKey = "\"ns_per_op\": ";
+    size_t position = 0;
+    while ((position = text.find(nameKey, position)) != std::string::npos) {
+        size_t nameStart = position + nameKey.size();
+        size_t nameEnd = text.find('"', nameStart);
+        size_t timeStart = text.find(timeKey, nameEnd);
+        if (nameEnd == std::string::npos || timeStart == std::string::npos) break;
+        baseline[text.substr(nameStart, nameEnd - nameStart)] = std::strtod(text.c_str() + timeStart + timeKey.size(), nullptr);
+        position = timeStart;
+    }
+    return true;
+}
+
+static bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--check") {
+            options.check = true;
+            continue;
+        }
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            return false;
+        }
+        if (arg == "--filter") {
+            options.filter = argv[++i];
+        } else if (arg == "--json") {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--baseline") {
+            options.baselinePath = argv[++i];
+        } else if (arg == "--min-time") {
+            options.minTimeMs = std::max(1.0, std::atof(argv[++i]));
+        } else if (arg == "--repetitions") {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--threshold") {
+            options.threshold = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--filter TEXT] [--json FILE] [--baseline FILE] [--min-time MS]"
+                  << " [--repetitions N] [--threshold PERCENT]" << std::endl;
+        std::cerr << "       " << argv[0] << " --check" << std::endl;
+        return 1;
+    }
+    if (options.check) {
+        return checkPlacements() == 0 ? 0 : 4;
+    }
+
+    std::map<std::string, double> baseline;
+    if (!options.baselinePath.empty() && !readBaseline(options.baselinePath, baseline)) {
+        return 1;
+    }
+
+    std::vector<Benchmark> benchmarks = coreBenchmarks();
+#ifdef TETROMINO_BENCH_RENDER
+    addRenderBenchmarks(benchmarks, options.filter);
+#endif
+
+    std::vector<BenchResult> results;
+    int regressions = 0;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const Benchmark& benchmark : benchmarks) {
+        if (benchmark.name.find(options.filter) == std::string::npos) continue;
+
+        BenchResult result = measure(benchmark, options);
+        results.push_back(result);
+
+        std::cout << std::left << std::setw(38) << result.name << std::right << std::setw(14) << result.nsPerOp << " ns/op"
+                  << "  (min " << result.minNs << ", max " << result.maxNs << ")";
+        auto previous = baseline.find(result.name);
+        if (previous != baseline.end() && previous->second > 0) {
+            double change = 100.0 * (result.nsPerOp - previous->second) / previous->second;
+            std::cout << "  " << std::showpos << change << "%" << std::noshowpos;
+            if (change > options.threshold) {
+                std::cout << "  REGRESSION";
+                regressions++;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (!options.jsonPath.empty()) {
+        std::ofstream out(options.jsonPath);
+        if (!out) {
+            std::cerr << "Unable to write " << options.jsonPath << std::endl;
+            return 1;
+        }
+        writeJson(out, results);
+    }
+    if (!baseline.empty()) {
+        std::cout << regressions << " regression(s) beyond " << options.threshold << "% against " << options.baselinePath << std::endl;
+    }
+    return regressions == 0 ? 0 : 3;
+}
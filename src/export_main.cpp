@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "GameCore.h"
+#include "VideoExporter.h"
+#include "WorkStealingPool.h"
+
+// Headless replay-to-video export: renders replays to .y4m files without a display or GPU
+
+struct ExportToolOptions {
+    ExportOptions video;
+    unsigned jobs = 1;          // Replays exported at once, each with its own rasterizer threads
+    std::string outputDir = "."; // "-" streams a single replay to stdout
+    std::vector<std::string> files;
+};
+
+static std::string outputPathFor(const std::string& replayPath, const std::string& outputDir) {
+    size_t slash = replayPath.find_last_of('/');
+    std::string name = slash == std::string::npos ? replayPath : replayPath.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos && dot > 0) name.resize(dot);
+    return outputDir + "/" + name + ".y4m";
+}
+
+static bool parseOptions(int argc, char* argv[], ExportToolOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            options.files.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        try {
+            if (arg == "--out") {
+                options.outputDir = argv[++i];
+            } else if (arg == "--width") {
+                options.video.width = std::stoi(argv[++i]);
+            } else if (arg == "--height") {
+                options.video.height = std::stoi(argv[++i]);
+            } else if (arg == "--cell") {
+                options.video.cellSize = std::max(0, std::stoi(argv[++i]));
+            } else if (arg == "--every") {
+                options.video.ticksPerFrame = static_cast<uint32_t>(std::max(1ul, std::stoul(argv[++i])));
+            } else if (arg == "--start") {
+                options.video.startTick = std::stoull(argv[++i]);
+            } else if (arg == "--frames") {
+                options.video.maxFrames = std::stoull(argv[++i]);
+            } else if (arg == "--threads") {
+                options.video.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--jobs") {
+                options.jobs = std::max(1u, static_cast<unsigned>(std::stoul(argv[++i])));
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Invalid value for " << arg << ". Error: " << e.what() << std::endl;
+            return false;
+        }
+    }
+    if (options.files.empty()) {
+        std::cerr << "No replay files given" << std::endl;
+        return false;
+    }
+    if (options.outputDir == "-" && options.files.size() > 1) {
+        std::cerr << "Only one replay can be streamed to stdout" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    ExportToolOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--out DIR|-] [--width N] [--height N] [--cell N] [--every TICKS] [--start TICK] [--frames N]"
+                  << " [--threads N] [--jobs N] FILE..." << std::endl;
+        return 1;
+    }
+
+    if (options.outputDir != "-") {
+        std::error_code error;
+        std::filesystem::create_directories(options.outputDir, error); // Opening the files reports any failure
+    }
+
+    std::vector<ExportResult> results(options.files.size());
+    WorkStealingPool pool(options.jobs);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < options.files.size(); ++i) {
+        pool.submit([&results, &options, i] {
+            std::string output = options.outputDir == "-" ? "-" : outputPathFor(options.files[i], options.outputDir);
+            results[i] = exportReplay(options.files[i], output, options.video);
+        });
+    }
+    pool.wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t frames = 0, drawn = 0, ticks = 0;
+    int failed = 0;
+    for (const ExportResult& result : results) {
+        frames += result.frames;
+        drawn += result.drawn;
+        ticks += result.ticks;
+        if (!result.ok) ++failed;
+    }
+
+    // Stdout may be the video, so the summary goes to stderr
+    std::cerr << std::fixed << std::setprecision(2);
+    std::cerr << "Replays:     " << results.size() << " (" << failed << " failed), " << options.jobs << " at a time" << std::endl;
+    std::cerr << "Elapsed:     " << seconds << " s" << std::endl;
+    std::cerr << "Frames:      " << frames << " (" << drawn << " drawn, the rest repeated)" << std::endl;
+    std::cerr << "Frames/sec:  " << frames / seconds << std::endl;
+    double videoSeconds = static_cast<double>(ticks) / GameCore::TICKS_PER_SECOND;
+    std::cerr << "Video time:  " << videoSeconds << " s (" << videoSeconds / seconds << "x real time)" << std::endl;
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "GameCore.h"
+#include "ServerProtocol.h"
+
+// Load generator for tetromino_server: many sessions sending random inputs at a fixed rate,
+// measuring the time from sending each input to receiving its update
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadOptions {
+    std::string socketPath = "tetromino.sock";
+    int port = 0;
+    int sessions = 1000;
+    unsigned threads = 1;
+    double seconds = 10.0;
+    double rate = 60.0; // Inputs per second per session, one tick each; 0 = next input as soon as the reply arrives
+    uint32_t seed = 1;
+    bool check = false; // Mirror every game locally and compare it with the decoded updates
+};
+
+struct ClientSession {
+    int fd = -1;
+    SessionView view;
+    std::unique_ptr<GameCore> mirror; // Only with --check
+    std::vector<uint8_t> input;
+    std::mt19937 policy;
+    uint32_t nextSeed = 0;
+    bool waiting = false;  // A request is in flight
+    bool timedInput = false; // The request in flight is an input, so its reply is timed
+    Clock::time_point sentAt;
+    Clock::time_point nextSend;
+};
+
+struct ThreadResult {
+    std::vector<uint32_t> latencies; // Nanoseconds
+    uint64_t games = 0;
+    uint64_t mismatches = 0;
+    int failures = 0;
+};
+
+static int connectToServer(const LoadOptions& options) {
+    int fd;
+    if (options.port != 0) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(options.port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    } else {
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, options.socketPath.c_str(), sizeof(address.sun_path) - 1);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+static bool sendAll(int fd, const std::vector<uint8_t>& bytes) {
+    return send(fd, bytes.data(), bytes.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(bytes.size()); // A few bytes always fit
+}
+
+// Random inputs, weighted towards moves so pieces travel before they drop
+static Input randomInput(std::mt19937& policy) {
+    static const Input choices[8] = {Input::Left, Input::Left, Input::Right, Input::Right,
+                                     Input::Rotate, Input::SoftDrop, Input::SoftDrop, Input::HardDrop};
+    return choices[policy() % 8];
+}
+
+static bool sendNewGame(ClientSession& session, std::vector<uint8_t>& frame) {
+    uint32_t seed = session.nextSeed++;
+    frame.clear();
+    ServerProtocol::encodeNewGame(frame, seed);
+    session.view = SessionView();
+    if (session.mirror) session.mirror->reset(seed);
+    session.waiting = true;
+    session.timedInput = false;
+    return sendAll(session.fd, frame);
+}
+
+static bool sendInput(ClientSession& session, std::vector<uint8_t>& frame) {
+    Input input = randomInput(session.policy);
+    frame.clear();
+    ServerProtocol::encodeInput(frame, input, 1);
+    if (session.mirror) session.mirror->step(input, 1);
+    session.waiting = true;
+    session.timedInput = true;
+    session.sentAt = Clock::now();
+    return sendAll(session.fd, frame);
+}
+
+static bool matchesMirror(const SessionView& view, const GameCore& game) {
+    const Tetromino& piece = game.getCurrentTetromino();
+    if (view.tick != static_cast<uint32_t>(game.getTick()) || view.score != game.getScore() || view.lines != game.getLinesCleared()
+        || view.piece != piece.getType() || view.rotation != piece.getRotation() || view.x != piece.getX() || view.y != piece.getY()
+        || view.next != game.getNextTetromino().getType() || view.held != game.getHeldTetromino().getType()
+        || view.isGameOver() != game.isGameOver()) {
+        return false;
+    }
+    for (int y = 0; y < Board::HEIGHT; ++y) {
+        if (view.rows[y] != game.getBoard().getRow(y)) return false;
+    }
+    return true;
+}
+
+static void runClients(const LoadOptions& options, int first, int count, ThreadResult& result) {
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<ClientSession> sessions(count);
+    std::vector<uint8_t> frame;
+    Clock::duration period = options.rate > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.rate))
+                                               : Clock::duration::zero();
+    Clock::time_point start = Clock::now();
+
+    for (int i = 0; i < count; ++i) {
+        ClientSession& session = sessions[i];
+        session.fd = connectToServer(options);
+        if (session.fd < 0) {
+            std::cerr << "Unable to connect session " << first + i << ": " << std::strerror(errno) << std::endl;
+            ++result.failures;
+            continue;
+        }
+        session.policy.seed(options.seed + static_cast<uint32_t>(first + i));
+        session.nextSeed = options.seed + static_cast<uint32_t>(first + i) * 1000003u; // Disjoint seed ranges
+        if (options.check) session.mirror.reset(new GameCore());
+        session.nextSend = start + period * i / count; // Spread the sessions over one period
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.ptr = &session;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, session.fd, &event);
+        if (!sendNewGame(session, frame)) ++result.failures;
+        ++result.games;
+    }
+
+    Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+    epoll_event events[256];
+    uint8_t buffer[16384];
+    while (Clock::now() < deadline) {
+        int ready = epoll_wait(epoll, events, 256, period > Clock::duration::zero() ? 1 : 100);
+        Clock::time_point now = Clock::now();
+        for (int i = 0; i < ready; ++i) {
+            ClientSession& session = *static_cast<ClientSession*>(events[i].data.ptr);
+            ssize_t received;
+            while ((received = recv(session.fd, buffer, sizeof(buffer), 0)) > 0) {
+                session.input.insert(session.input.end(), buffer, buffer + received);
+            }
+            if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                std::cerr << "Server closed a session" << std::endl;
+                ++result.failures;
+                close(session.fd); // Also leaves the epoll set
+                session.fd = -1;
+                continue;
+            }
+
+            size_t position = 0;
+            while (position < session.input.size() && session.input.size() - position > session.input[position]) {
+                uint8_t length = session.input[position];
+                const uint8_t* body = &session.input[position + 1];
+                position += 1 + length;
+                if (length == 0 || body[0] != ServerProtocol::UPDATE || !ServerProtocol::decodeUpdate(body + 1, length - 1u, session.view)) {
+                    ++result.failures;
+                    continue;
+                }
+                if (session.timedInput) {
+                    result.latencies.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - session.sentAt).count()));
+                }
+                session.waiting = false;
+                if (session.mirror && !matchesMirror(session.view, *session.mirror)) ++result.mismatches;
+            }
+            session.input.erase(session.input.begin(), session.input.begin() + static_cast<std::ptrdiff_t>(position));
+
+            if (!session.waiting && session.view.isGameOver()) {
+                if (!sendNewGame(session, frame)) ++result.failures;
+                ++result.games;
+            } else if (!session.waiting && period == Clock::duration::zero()) {
+                if (!sendInput(session, frame)) ++result.failures;
+            }
+        }
+
+        if (period > Clock::duration::zero()) {
+            for (ClientSession& session : sessions) {
+                if (session.fd < 0 || session.waiting || now < session.nextSend) continue;
+                if (!sendInput(session, frame)) ++result.failures;
+                session.nextSend += period;
+                if (session.nextSend < now) session.nextSend = now + period; // Fell behind; don't burst
+            }
+        }
+    }
+
+    for (ClientSession& session : sessions) {
+        if (session.fd >= 0) close(session.fd);
+    }
+    close(epoll);
+}
+
+static double percentile(std::vector<uint32_t>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+    return sorted[index] / 1000.0;
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            options.socketPath = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            options.port = std::atoi(argv[++i]);
+        } else if (arg == "--sessions" && i + 1 < argc) {
+            options.sessions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            options.seconds = std::max(0.1, std::atof(argv[++i]));
+        } else if (arg == "--rate" && i + 1 < argc) {
+            options.rate = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--check") {
+            options.check = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--socket PATH | --port N] [--sessions N] [--threads N] [--seconds S] [--rate HZ] [--seed N] [--check]" << std::endl;
+            return 1;
+        }
+    }
+
+    rlimit limit; // One descriptor per session
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    unsigned threadCount = std::min(options.threads, static_cast<unsigned>(options.sessions));
+    std::vector<ThreadResult> results(threadCount);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        int first = options.sessions * static_cast<int>(t) / static_cast<int>(threadCount);
+        int last = options.sessions * static_cast<int>(t + 1) / static_cast<int>(threadCount);
+        threads.emplace_back(runClients, std::cref(options), first, last - first, std::ref(results[t]));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<uint32_t> latencies;
+    uint64_t games = 0, mismatches = 0;
+    int failures = 0;
+    for (ThreadResult& result : results) {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        games += result.games;
+        mismatches += result.mismatches;
+        failures += result.failures;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Sessions:    " << options.sessions << " on " << threadCount << " client threads" << std::endl;
+    std::cout << "Inputs:      " << latencies.size() << " (" << latencies.size() / options.seconds << "/s)" << std::endl;
+    std::cout << "Games:       " << games << std::endl;
+    std::cout << "Latency us:  p50 " << percentile(latencies, 0.50) << "  p90 " << percentile(latencies, 0.90) << "  p99 "
+              << percentile(latencies, 0.99) << "  p99.9 " << percentile(latencies, 0.999) << "  max "
+              << (latencies.empty() ? 0.0 : latencies.back() / 1000.0) << std::endl;
+    if (options.check) {
+        std::cout << "Mismatches:  " << mismatches << std::endl;
+    }
+    if (failures > 0) {
+        std::cout << "Failures:    " << failures << std::endl;
+    }
+    return failures > 0 || mismatches > 0 ? 2 : 0;
+}
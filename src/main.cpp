@@ -3,7 +3,95 @@
 #include <SDL_mixer.h>
 #include <iostream>
 #include <algorithm> // For std::min
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <vector>
 #include "Game.h"
+#include "GameWall.h"
+
+// Milliseconds per frame spent rendering the game with the given cell path
+static double timeFrames(Game& game, SDL_Window* window, SDL_Renderer* renderer, int frames, bool cached, bool batched) {
+    game.setCachedBoard(cached);
+    game.setBatchedRendering(batched);
+
+    int windowWidth, windowHeight;
+    SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+    int cellSize = std::min(windowWidth / Board::WIDTH, windowHeight / Board::HEIGHT);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int frame = 0; frame < frames; ++frame) {
+        SDL_PumpEvents();
+        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+        SDL_RenderClear(renderer);
+        game.render(renderer, cellSize);
+        SDL_RenderPresent(renderer);
+    }
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+    return 1000.0 * static_cast<double>(elapsed) / static_cast<double>(SDL_GetPerformanceFrequency()) / frames;
+}
+
+// Renders a nearly full board with each board path and prints the frame times
+static void runRenderBench(Game& game, SDL_Window* window, SDL_Renderer* renderer, int frames) {
+    for (int y = 0; y < Board::HEIGHT - 4; ++y) { // Leave room for the current piece
+        game.addGarbage(1, y % Board::WIDTH, TetrominoTables::COLORS[y % (TetrominoTables::TYPE_COUNT - 1)]);
+    }
+
+    int windowWidth, windowHeight;
+    SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+    game.waitForAssets(); // Time frames with text, as in play
+    timeFrames(game, window, renderer, 10, true, true); // Warm up text caches and the driver
+
+    double cached = timeFrames(game, window, renderer, frames, true, true);
+    double batched = timeFrames(game, window, renderer, frames, false, true);
+    double immediate = timeFrames(game, window, renderer, frames, false, false);
+    game.setCachedBoard(true);
+    game.setBatchedRendering(true);
+    std::cout << "Window:    " << windowWidth << "x" << windowHeight << "\n"
+              << "Frames:    " << frames << " per path\n"
+              << "Cached:    " << cached << " ms/frame\n"
+              << "Batched:   " << batched << " ms/frame\n"
+              << "Per-cell:  " << immediate << " ms/frame\n";
+}
+
+// Spectator wall: always animating, so it renders every frame up to the FPS cap
+static void runWall(SDL_Renderer* renderer, GameWall& wall, FrameProfiler& profiler, int fpsCap) {
+    Uint32 frameDelay = fpsCap > 0 ? 1000 / fpsCap : 0;
+    Uint32 lastRender = SDL_GetTicks() - frameDelay;
+    bool quit = false;
+    while (!quit) {
+        Uint32 sinceRender = SDL_GetTicks() - lastRender;
+        int timeout = sinceRender >= frameDelay ? 0 : static_cast<int>(frameDelay - sinceRender);
+
+        SDL_Event e;
+        int hasEvent = SDL_WaitEventTimeout(&e, timeout);
+        profiler.beginFrame();
+        while (hasEvent) {
+            if (e.type == SDL_QUIT || (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE)) {
+                quit = true;
+            }
+            FrameProfiler::Scope scope(&profiler, FramePhase::Events);
+            hasEvent = SDL_PollEvent(&e);
+        }
+
+        {
+            FrameProfiler::Scope scope(&profiler, FramePhase::Update);
+            wall.update();
+        }
+
+        lastRender = SDL_GetTicks();
+        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+        SDL_RenderClear(renderer);
+        wall.render(renderer);
+        {
+            FrameProfiler::Scope scope(&profiler, FramePhase::Present);
+            SDL_RenderPresent(renderer);
+        }
+        profiler.endFrame();
+    }
+}
 
 int main(int argc, char* argv[]) {
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) { // Initialize audio subsystem
@@ -29,11 +117,61 @@ int main(int argc, char* argv[]) {
     int windowWidth = Board::WIDTH * 20 + 150; // Board width * default cell size + space for score
     int windowHeight = Board::HEIGHT * 20; // Board height * default cell size
 
-    // Parse command-line arguments for resolution
-    if (argc >= 3) {
+    // Parse command-line arguments: optional flags, then resolution
+    bool autoplay = false;
+    int benchFrames = 0;
+    bool vsync = false;
+    int fpsCap = 60; // 0 renders every change as soon as it happens
+    uint32_t seed = static_cast<uint32_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    bool record = true;
+    std::string recordPath; // Default: replays/<seed>-<time>.ttr
+    std::string replayPath;
+    int renderEvery = 1;
+    std::string tracePath; // Chrome trace of every frame's phases
+    std::string assetPack; // Default: assets.pak next to the executable, else loose files
+    int wallBots = 0;
+    std::vector<std::string> wallReplays;
+    unsigned threads = 0; // Wall simulation threads; 0 = one per core
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--autoplay") {
+            autoplay = true;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--no-record") {
+            record = false;
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--render-every" && i + 1 < argc) {
+            renderEvery = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--wall" && i + 1 < argc) {
+            wallBots = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--wall-replay" && i + 1 < argc) {
+            wallReplays.push_back(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--assets" && i + 1 < argc) {
+            assetPack = argv[++i];
+        } else if (arg == "--vsync") {
+            vsync = true;
+        } else if (arg == "--fps" && i + 1 < argc) {
+            fpsCap = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--render-bench" && i + 1 < argc) {
+            benchFrames = std::max(1, std::atoi(argv[++i]));
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() >= 2) {
         try {
-            windowWidth = std::stoi(argv[1]);
-            windowHeight = std::stoi(argv[2]);
+            windowWidth = std::stoi(positional[0]);
+            windowHeight = std::stoi(positional[1]);
         } catch (const std::invalid_argument& e) {
             std::cerr << "Invalid resolution arguments. Using default. Error: " << e.what() << std::endl;
         } catch (const std::out_of_range& e) {
@@ -50,7 +188,8 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    Uint32 rendererFlags = SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, rendererFlags);
     if (renderer == nullptr) {
         std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
         SDL_DestroyWindow(window);
@@ -60,31 +199,112 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    Game game;
-    bool quit = false;
-    SDL_Event e;
-
-    while (!quit) {
-        while (SDL_PollEvent(&e) != 0) {
-            if (e.type == SDL_QUIT) {
-                quit = true;
+    if (wallBots > 0 || !wallReplays.empty()) { // Scoped like the game below
+        FrameProfiler profiler;
+        if (!tracePath.empty()) {
+            profiler.startTrace(tracePath);
+        }
+        GameWall wall(threads, assetPack);
+        wall.setProfiler(&profiler);
+        for (const std::string& path : wallReplays) {
+            wall.addReplay(path);
+        }
+        for (int i = 0; i < wallBots; ++i) {
+            wall.addBot(seed + static_cast<uint32_t>(i));
+        }
+        std::cout << "Wall: " << wall.getBoardCount() << " boards, bot seeds from " << seed << std::endl;
+        runWall(renderer, wall, profiler, fpsCap);
+    } else { // Scoped so the game's textures, font and sounds are freed before the renderer and audio
+        FrameProfiler profiler;
+        if (!tracePath.empty()) {
+            profiler.startTrace(tracePath);
+        }
+        Game game(seed, assetPack);
+        game.setAutoplay(autoplay);
+        game.setProfiler(&profiler);
+        bool quit = false;
+        if (!replayPath.empty()) {
+            // Re-simulate as fast as possible, drawing one frame per renderEvery ticks
+            quit = !game.startPlayback(replayPath, renderEvery);
+            fpsCap = 0;
+        } else {
+            std::cout << "Seed: " << seed << std::endl; // Pass with --seed to replay the same piece sequence
+            if (record && benchFrames == 0) {
+                if (recordPath.empty()) {
+                    std::error_code error;
+                    std::filesystem::create_directories("replays", error); // Opening the file reports any failure
+                    recordPath = "replays/" + std::to_string(seed) + "-" + std::to_string(std::time(nullptr)) + ".ttr";
+                }
+                if (game.startRecording(recordPath)) {
+                    std::cout << "Recording to " << recordPath << std::endl;
+                }
             }
-            game.handleInput(e);
         }
+        if (benchFrames > 0) {
+            runRenderBench(game, window, renderer, benchFrames);
+            quit = true;
+        } else if (!quit) {
+            game.start(); // The game ticks on its own thread from here on
+        }
+        SDL_Event e;
 
-        game.update();
+        // The game runs on its own thread and posts an event with every new snapshot, so the
+        // loop sleeps until the next event and only renders frames that changed
+        Uint32 frameDelay = fpsCap > 0 ? 1000 / fpsCap : 0;
+        Uint32 lastRender = SDL_GetTicks() - frameDelay;
 
-        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
-        SDL_RenderClear(renderer);
+        while (!quit) {
+            Uint32 now = SDL_GetTicks();
+            int timeout = -1;
+            if (game.needsRender()) {
+                Uint32 sinceRender = now - lastRender;
+                timeout = sinceRender >= frameDelay ? 0 : static_cast<int>(frameDelay - sinceRender);
+            }
 
-        // Calculate cellSize based on window dimensions
-        int currentWindowWidth, currentWindowHeight;
-        SDL_GetWindowSize(window, &currentWindowWidth, &currentWindowHeight);
-        int cellSize = std::min(currentWindowWidth / Board::WIDTH, currentWindowHeight / Board::HEIGHT);
+            int hasEvent = timeout < 0 ? SDL_WaitEvent(&e) : SDL_WaitEventTimeout(&e, timeout);
+            profiler.beginFrame(); // Frame time counts from wake-up, not the idle wait
+            while (hasEvent) {
+                if (e.type == SDL_QUIT) {
+                    quit = true;
+                } else if (e.type == SDL_WINDOWEVENT) {
+                    game.requestRender(); // Exposed, resized, ...
+                }
+                {
+                    FrameProfiler::Scope scope(&profiler, FramePhase::Input);
+                    game.handleInput(e);
+                }
+                FrameProfiler::Scope scope(&profiler, FramePhase::Events);
+                hasEvent = SDL_PollEvent(&e);
+            }
 
-        game.render(renderer, cellSize);
+            {
+                FrameProfiler::Scope scope(&profiler, FramePhase::Update);
+                game.update();
+            }
 
-        SDL_RenderPresent(renderer);
+            now = SDL_GetTicks();
+            if (!game.needsRender() || now - lastRender < frameDelay) {
+                profiler.endPass(); // Nothing new to show, or over the FPS cap: not a frame
+                continue;
+            }
+            lastRender = now;
+
+            SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+            SDL_RenderClear(renderer);
+
+            // Calculate cellSize based on window dimensions
+            int currentWindowWidth, currentWindowHeight;
+            SDL_GetWindowSize(window, &currentWindowWidth, &currentWindowHeight);
+            int cellSize = std::min(currentWindowWidth / Board::WIDTH, currentWindowHeight / Board::HEIGHT);
+
+            game.render(renderer, cellSize);
+
+            {
+                FrameProfiler::Scope scope(&profiler, FramePhase::Present);
+                SDL_RenderPresent(renderer);
+            }
+            profiler.endFrame();
+        }
     }
 
     SDL_DestroyRenderer(renderer);
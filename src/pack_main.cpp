@@ -0,0 +1,109 @@
+// tetromino_pack: bundles the game's assets into one file the game maps at startup.
+//
+//   tetromino_pack OUT.pak [--raw NAME FILE] [--sound NAME FILE] ...
+//
+// --raw stores a file as is (the font; the music, which is streamed while playing).
+// --sound decodes a sound effect with SDL_mixer and stores it as 16-bit PCM WAV in the
+// game's output format, so loading it at startup is a copy instead of an MP3 decode.
+
+#include "AssetPack.h"
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static const int SAMPLE_RATE = 44100; // Same as Mix_OpenAudio in main.cpp
+static const int CHANNELS = 2;
+
+static bool readFile(const std::string& path, std::vector<uint8_t>& bytes) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        std::cerr << "Unable to open " << path << std::endl;
+        return false;
+    }
+    bytes.clear();
+    uint8_t chunk[65536];
+    size_t count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + count);
+    }
+    bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+    if (!ok) std::cerr << "Error while reading " << path << std::endl;
+    return ok;
+}
+
+static void put(std::vector<uint8_t>& out, uint32_t value, int count) {
+    for (int i = 0; i < count; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+// Decodes any format SDL_mixer reads into a canonical PCM WAV
+static bool decodeSound(const std::string& path, std::vector<uint8_t>& wav) {
+    Mix_Chunk* chunk = Mix_LoadWAV(path.c_str());
+    if (chunk == nullptr) {
+        std::cerr << "Unable to decode " << path << ": " << Mix_GetError() << std::endl;
+        return false;
+    }
+
+    const uint32_t bytesPerFrame = CHANNELS * 2;
+    wav.clear();
+    wav.insert(wav.end(), {'R', 'I', 'F', 'F'});
+    put(wav, 36 + chunk->alen, 4);
+    wav.insert(wav.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    put(wav, 16, 4);
+    put(wav, 1, 2); // PCM
+    put(wav, CHANNELS, 2);
+    put(wav, SAMPLE_RATE, 4);
+    put(wav, SAMPLE_RATE * bytesPerFrame, 4);
+    put(wav, bytesPerFrame, 2);
+    put(wav, 16, 2);
+    wav.insert(wav.end(), {'d', 'a', 't', 'a'});
+    put(wav, chunk->alen, 4);
+    wav.insert(wav.end(), chunk->abuf, chunk->abuf + chunk->alen);
+    Mix_FreeChunk(chunk);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argv[1][0] == '-') {
+        std::cerr << "Usage: tetromino_pack OUT.pak [--raw NAME FILE] [--sound NAME FILE] ..." << std::endl;
+        return 1;
+    }
+
+    // Sounds are decoded without playing anything, so no audio device is needed
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_AUDIO) < 0 || Mix_OpenAudio(SAMPLE_RATE, AUDIO_S16LSB, CHANNELS, 2048) < 0) {
+        std::cerr << "SDL_mixer could not initialize! SDL_mixer Error: " << Mix_GetError() << std::endl;
+        return 1;
+    }
+
+    AssetPackWriter writer;
+    bool ok = true;
+    for (int i = 2; i < argc && ok; ++i) {
+        std::string arg = argv[i];
+        if ((arg != "--raw" && arg != "--sound") || i + 2 >= argc) {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            ok = false;
+            break;
+        }
+        std::string name = argv[++i];
+        std::string path = argv[++i];
+
+        std::vector<uint8_t> bytes;
+        ok = arg == "--raw" ? readFile(path, bytes) : decodeSound(path, bytes);
+        if (ok) {
+            std::cout << name << ": " << bytes.size() << " bytes from " << path << std::endl;
+            writer.add(name, std::move(bytes));
+        }
+    }
+    ok = ok && writer.write(argv[1]);
+
+    Mix_CloseAudio();
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include "GameServer.h"
+
+// Headless game server: thousands of sessions over a Unix domain socket or loopback TCP
+
+static std::atomic<bool> stopRequested(false);
+
+static void requestStop(int) {
+    stopRequested = true;
+}
+
+// Every session holds a descriptor, so lift the soft limit as far as allowed
+static void raiseDescriptorLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ServerOptions options;
+    options.socketPath = "tetromino.sock";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            options.socketPath = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            options.port = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--stats" && i + 1 < argc) {
+            options.statsSeconds = std::max(0, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--socket PATH | --port N] [--threads N] [--stats SECONDS]" << std::endl;
+            return 1;
+        }
+    }
+
+    raiseDescriptorLimit();
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    GameServer server(options);
+    if (!server.start()) return 1;
+    std::cout << "Listening on " << (options.port ? "127.0.0.1:" + std::to_string(options.port) : options.socketPath)
+              << " with " << server.getThreadCount() << " worker threads" << std::endl;
+    server.run(stopRequested);
+    std::cout << "Shutting down" << std::endl;
+    return 0;
+}
@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "AllocTracker.h"
+#include "Bot.h"
+#include "FrameRasterizer.h"
+#include "GameCore.h"
+#include "GameSimulation.h"
+#include "Replay.h"
+#include "TranspositionTable.h"
+#include "WorkStealingPool.h"
+#include "tetromino_env.h"
+
+// Batch self-play: runs many independent seeded games across all cores and reports throughput
+
+struct SimOptions {
+    int games = 10000;
+    unsigned threads = 0; // 0 = all hardware threads
+    uint32_t seed = 1;
+    int maxPieces = 10000; // Cap per game so strong policies still terminate
+    int gamesPerJob = 16;  // Games batched into one pool job
+    bool useBot = false;   // Beam search bot instead of the random policy
+    uint32_t ticksPerInput = 0; // Game ticks between policy inputs; 0 = no time passes, so gravity never fires
+    std::string recordDir;      // Write a replay of every game here when set
+    std::vector<std::string> verifyFiles; // Replays to re-simulate instead of playing new games
+    BotConfig bot;
+    size_t tableMegabytes = 0; // Feature cache shared by every game's bot; 0 = none
+    int allocCheckPieces = 0;  // Play this many pieces through GameSimulation and count allocations instead
+    int envCheckSteps = 0;     // Step the tetromino_env C API this many times and count allocations instead
+};
+
+struct GameStats {
+    int pieces = 0;
+    int lines = 0;
+    int score = 0;
+    int clears[4] = {0, 0, 0, 0};
+    uint64_t ticks = 0;
+};
+
+// Random policy: rotate and shift by a random amount, then hard drop
+template <typename Play>
+static void playRandomPiece(std::mt19937& policyRng, Play&& play) {
+    int rotations = static_cast<int>(policyRng() % 4);
+    int shift = static_cast<int>(policyRng() % Board::WIDTH) - Board::WIDTH / 2;
+
+    for (int i = 0; i < rotations; ++i) {
+        play(Input::Rotate);
+    }
+    Input direction = shift < 0 ? Input::Left : Input::Right;
+    for (int i = 0; i < std::abs(shift); ++i) {
+        play(direction);
+    }
+    play(Input::HardDrop);
+}
+
+static GameStats runGame(uint32_t seed, const SimOptions& options) {
+    GameCore game(seed);
+
+    ReplayWriter recorder;
+    if (!options.recordDir.empty()) {
+        recorder.open(options.recordDir + "/game-" + std::to_string(seed) + ".ttr", seed);
+    }
+    auto play = [&](Input input) {
+        recorder.record(game.getTick(), input);
+        game.step(input, options.ticksPerInput);
+    };
+
+    if (options.useBot) {
+        Bot bot(options.bot);
+        while (!game.isGameOver() && game.getPiecesPlaced() < options.maxPieces) {
+            play(bot.nextInput(game));
+        }
+    } else {
+        std::mt19937 policyRng(seed ^ 0x9e3779b9u);
+        while (!game.isGameOver() && game.getPiecesPlaced() < options.maxPieces) {
+            playRandomPiece(policyRng, play);
+        }
+    }
+    recorder.finish(game);
+
+    GameStats stats;
+    stats.pieces = game.getPiecesPlaced();
+    stats.lines = game.getLinesCleared();
+    stats.score = game.getScore();
+    stats.ticks = game.getTick();
+    for (int lines = 1; lines <= 4; ++lines) {
+        stats.clears[lines - 1] = game.getClearCount(lines);
+    }
+    return stats;
+}
+
+// Re-simulates recorded games and checks each against the result stored in its trailer
+static int verifyReplays(const SimOptions& options) {
+    std::vector<ReplayCheck> checks(options.verifyFiles.size());
+    WorkStealingPool pool(options.threads);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < checks.size(); ++i) {
+        pool.submit([&checks, &options, i] {
+            checks[i] = verifyReplay(options.verifyFiles[i]);
+        });
+    }
+    pool.wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t matched = 0, incomplete = 0, failed = 0;
+    uint64_t totalTicks = 0;
+    for (size_t i = 0; i < checks.size(); ++i) {
+        const ReplayCheck& check = checks[i];
+        totalTicks += check.replayed.tick;
+        if (check.matches) {
+            matched++;
+        } else if (!check.loaded) {
+            failed++; // Reader already said why
+        } else if (check.corrupt) {
+            failed++;
+            std::cerr << options.verifyFiles[i] << ": CORRUPT after tick " << check.replayed.tick << ", replayed score "
+                      << check.replayed.score << std::endl;
+        } else if (!check.complete) {
+            incomplete++;
+            std::cerr << options.verifyFiles[i] << ": no trailer, replayed score " << check.replayed.score << std::endl;
+        } else {
+            failed++;
+            std::cerr << options.verifyFiles[i] << ": MISMATCH, recorded score " << check.recorded.score
+                      << ", replayed " << check.replayed.score << std::endl;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Replays:     " << checks.size() << " on " << pool.getThreadCount() << " threads" << std::endl;
+    std::cout << "Elapsed:     " << seconds << " s" << std::endl;
+    std::cout << "Replays/sec: " << checks.size() / seconds << std::endl;
+    std::cout << "Ticks/sec:   " << totalTicks / seconds << std::endl;
+    std::cout << "Verified:    " << matched << " match, " << incomplete << " incomplete, " << failed << " failed" << std::endl;
+    return failed == 0 ? 0 : 2;
+}
+
+// Plays autoplay games through GameSimulation's tick and publish path on this thread, with a
+// scripted player input now and then, and counts heap allocations once each game has warmed up.
+// Every new snapshot is also drawn by the headless FrameRasterizer, the way tetromino_export draws
+// frames; the SDL window's frames are not covered. Any allocation in that steady state fails the check.
+static int checkAllocations(const SimOptions& options) {
+    if (!AllocTracker::isEnabled()) {
+        std::cerr << "Allocation tracking is not compiled in" << std::endl;
+        return 1;
+    }
+    const int WARM_UP_PIECES = 50; // Per game: buffers grow to their working size
+    const Input SCRIPT[4] = {Input::Left, Input::Rotate, Input::Right, Input::Hold};
+
+    FrameRasterizer rasterizer(320, 240);
+    std::vector<uint32_t> pixels(static_cast<size_t>(rasterizer.getWidth()) * rasterizer.getHeight());
+    std::vector<uint8_t> yuv(FrameRasterizer::yuv420Size(rasterizer.getWidth(), rasterizer.getHeight()));
+
+    int pieces = 0, games = 0;
+    uint64_t ticks = 0, frames = 0, allocations = 0, frameAllocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (pieces < options.allocCheckPieces) {
+        uint32_t seed = options.seed + static_cast<uint32_t>(games++);
+        GameSimulation sim(seed);
+        sim.setAutoplay(true);
+        if (!options.recordDir.empty()) {
+            sim.startRecording(options.recordDir + "/alloc-check-" + std::to_string(seed) + ".ttr");
+        }
+        uint64_t before = 0, drawing = 0; // Allocations while drawing are counted apart from the simulation's
+        bool counting = false;
+        int gamePieces = 0;
+        for (uint64_t tick = 0; pieces + gamePieces < options.allocCheckPieces; ++tick) {
+            if (tick % 97 == 0) sim.send({SimCommand::Kind::Input, SCRIPT[(tick / 97) % 4]});
+            sim.advance(1);
+            bool published = sim.acquireSnapshot();
+
+            const RenderSnapshot& snapshot = sim.getSnapshot();
+            if (snapshot.gameOver) break;
+            if (!counting && snapshot.pieces >= WARM_UP_PIECES) {
+                counting = true;
+                before = AllocTracker::thisThread();
+            }
+            if (counting) {
+                gamePieces = snapshot.pieces - WARM_UP_PIECES;
+                ++ticks;
+            }
+            if (published) {
+                uint64_t drawStart = AllocTracker::thisThread();
+                rasterizer.draw(snapshot, pixels.data());
+                FrameRasterizer::toYuv420(pixels.data(), rasterizer.getWidth(), rasterizer.getHeight(), yuv.data());
+                if (counting) {
+                    drawing += AllocTracker::thisThread() - drawStart;
+                    ++frames;
+                }
+            }
+        }
+        if (counting) {
+            allocations += AllocTracker::thisThread() - before - drawing;
+            frameAllocations += drawing;
+        }
+        pieces += gamePieces;
+        if (games > 1000 && pieces == 0) break; // Every game ends during warm-up
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Games:       " << games << " (" << WARM_UP_PIECES << " warm-up pieces each)" << std::endl;
+    std::cout << "Elapsed:     " << std::fixed << std::setprecision(2) << seconds << " s" << std::endl;
+    std::cout << "Checked:     " << pieces << " pieces, " << ticks << " ticks" << std::endl;
+    std::cout << "Frames:      " << frames << " drawn headless at " << rasterizer.getWidth() << "x" << rasterizer.getHeight()
+              << " (SDL window frames not covered)" << std::endl;
+    std::cout << "Allocations: " << allocations << " simulation, " << frameAllocations << " frames" << std::endl;
+    if (pieces < options.allocCheckPieces) {
+        std::cerr << "Only " << pieces << " of " << options.allocCheckPieces << " pieces were played" << std::endl;
+        return 4;
+    }
+    return allocations == 0 && frameAllocations == 0 ? 0 : 4;
+}
+
+// Steps the RL environment through its C API with random actions, slices on several threads,
+// and counts heap allocations on every thread once it has warmed up
+static int checkEnvAllocations(const SimOptions& options) {
+    if (!AllocTracker::isEnabled()) {
+        std::cerr << "Allocation tracking is not compiled in" << std::endl;
+        return 1;
+    }
+    const int GAMES = 64;
+    const int WARM_UP_STEPS = 100;
+    int threads = options.threads > 1 ? static_cast<int>(options.threads) : 4;
+    TetrominoEnv* env = tetromino_env_create(GAMES, options.seed, threads, 1);
+    if (env == nullptr) {
+        std::cerr << "Unable to create the environment" << std::endl;
+        return 1;
+    }
+
+    std::vector<uint8_t> occupancy(GAMES * TETROMINO_BOARD_HEIGHT * TETROMINO_BOARD_WIDTH), done(GAMES), actions(GAMES);
+    std::vector<int8_t> pieces(GAMES * 6);
+    std::vector<int32_t> scores(GAMES * 2);
+    std::vector<float> rewards(GAMES);
+    TetrominoEnvBuffers buffers = {occupancy.data(), pieces.data(), pieces.data() + GAMES, pieces.data() + 2 * GAMES, pieces.data() + 3 * GAMES,
+                                   pieces.data() + 4 * GAMES, pieces.data() + 5 * GAMES, scores.data(), scores.data() + GAMES, rewards.data(), done.data()};
+    tetromino_env_set_buffers(env, &buffers);
+    tetromino_env_reset(env);
+
+    const uint8_t ACTIONS[6] = {TETROMINO_INPUT_LEFT, TETROMINO_INPUT_RIGHT, TETROMINO_INPUT_ROTATE, TETROMINO_INPUT_SOFT_DROP,
+                                TETROMINO_INPUT_HARD_DROP, TETROMINO_INPUT_HOLD};
+    std::mt19937 rng(options.seed);
+    uint64_t before = 0, episodes = 0;
+    for (int step = 0; step < WARM_UP_STEPS + options.envCheckSteps; ++step) {
+        if (step == WARM_UP_STEPS) before = AllocTracker::total();
+        for (uint8_t& action : actions) {
+            action = ACTIONS[rng() % 6];
+        }
+        tetromino_env_step(env, actions.data());
+        for (uint8_t finished : done) {
+            episodes += finished;
+        }
+    }
+    uint64_t allocations = AllocTracker::total() - before;
+    tetromino_env_destroy(env);
+
+    std::cout << "Games:       " << GAMES << " on " << threads << " threads" << std::endl;
+    std::cout << "Checked:     " << options.envCheckSteps << " steps (" << WARM_UP_STEPS << " warm-up), " << episodes << " games finished" << std::endl;
+    std::cout << "Allocations: " << allocations << std::endl;
+    return allocations == 0 ? 0 : 4;
+}
+
+static bool parseOptions(int argc, char* argv[], SimOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        try {
+            if (arg == "--games") {
+                options.games = std::stoi(argv[++i]);
+                if (options.games <= 0) {
+                    std::cerr << "--games must be at least 1" << std::endl;
+                    return false;
+                }
+            } else if (arg == "--threads") {
+                options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--seed") {
+                options.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--max-pieces") {
+                options.maxPieces = std::stoi(argv[++i]);
+                if (options.maxPieces < 0) {
+                    std::cerr << "--max-pieces must not be negative" << std::endl;
+                    return false;
+                }
+            } else if (arg == "--policy") {
+                std::string policy = argv[++i];
+                if (policy != "random" && policy != "bot") {
+                    std::cerr << "Unknown policy: " << policy << std::endl;
+                    return false;
+                }
+                options.useBot = policy == "bot";
+            } else if (arg == "--beam") {
+                options.bot.beamWidth = std::max(1, std::stoi(argv[++i]));
+            } else if (arg == "--depth") {
+                options.bot.depth = std::max(1, std::stoi(argv[++i]));
+            } else if (arg == "--env-alloc-check") {
+                options.envCheckSteps = std::max(1, std::stoi(argv[++i]));
+            } else if (arg == "--alloc-check") {
+                options.allocCheckPieces = std::max(1, std::stoi(argv[++i]));
+            } else if (arg == "--table") {
+                options.tableMegabytes = std::stoul(argv[++i]);
+            } else if (arg == "--weights") {
+                // Comma-separated: height,holes,bumpiness,wells,lines
+                float* weights[5] = {&options.bot.weights.aggregateHeight, &options.bot.weights.holes, &options.bot.weights.bumpiness,
+                                     &options.bot.weights.wells, &options.bot.weights.linesCleared};
+                std::string list = argv[++i];
+                if (std::count(list.begin(), list.end(), ',') != 4) {
+                    std::cerr << "--weights takes exactly five comma-separated values" << std::endl;
+                    return false;
+                }
+                size_t position = 0;
+                for (int w = 0; w < 5; ++w) {
+                    size_t comma = list.find(',', position);
+                    std::string value = list.substr(position, comma - position);
+                    size_t used = 0;
+                    *weights[w] = std::stof(value, &used);
+                    if (used != value.size()) {
+                        std::cerr << "Invalid weight: " << value << std::endl;
+                        return false;
+                    }
+                    position = comma + 1;
+                }
+            } else if (arg == "--record") {
+                options.recordDir = argv[++i];
+            } else if (arg == "--verify") {
+                options.verifyFiles.assign(argv + i + 1, argv + argc);
+                break;
+            } else if (arg == "--input-every") {
+                options.ticksPerInput = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--batch") {
+                options.gamesPerJob = std::max(1, std::stoi(argv[++i]));
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Invalid value for " << arg << ". Error: " << e.what() << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SimOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--games N] [--threads N] [--seed N] [--max-pieces N] [--batch N] [--input-every TICKS]"
+                  << " [--policy random|bot] [--beam N] [--depth N] [--weights h,holes,bump,wells,lines] [--table MB] [--record DIR]" << std::endl;
+        std::cerr << "       " << argv[0] << " [--threads N] --verify FILE..." << std::endl;
+        std::cerr << "       " << argv[0] << " [--seed N] [--record DIR] --alloc-check PIECES" << std::endl;
+        std::cerr << "       " << argv[0] << " [--seed N] [--threads N] --env-alloc-check STEPS" << std::endl;
+        return 1;
+    }
+    if (options.allocCheckPieces > 0) {
+        return checkAllocations(options);
+    }
+    if (options.envCheckSteps > 0) {
+        return checkEnvAllocations(options);
+    }
+    if (!options.verifyFiles.empty()) {
+        return verifyReplays(options);
+    }
+    if (!options.recordDir.empty() && options.ticksPerInput == 0) {
+        options.ticksPerInput = 1; // A replay applies at most one input per tick
+    }
+    std::unique_ptr<TranspositionTable> table;
+    if (options.tableMegabytes > 0) {
+        table.reset(new TranspositionTable(options.tableMegabytes));
+        options.bot.table = table.get();
+    }
+
+    std::vector<GameStats> results(options.games);
+    WorkStealingPool pool(options.threads);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int first = 0; first < options.games; first += options.gamesPerJob) {
+        int last = std::min(options.games, first + options.gamesPerJob);
+        pool.submit([&results, &options, first, last] {
+            for (int i = first; i < last; ++i) {
+                results[i] = runGame(options.seed + static_cast<uint32_t>(i), options);
+            }
+        });
+    }
+    pool.wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    GameStats total;
+    int bestScore = 0;
+    long long totalPieces = 0, totalLines = 0, totalScore = 0;
+    uint64_t totalTicks = 0;
+    for (const GameStats& stats : results) {
+        totalPieces += stats.pieces;
+        totalLines += stats.lines;
+        totalScore += stats.score;
+        totalTicks += stats.ticks;
+        bestScore = std::max(bestScore, stats.score);
+        for (int i = 0; i < 4; ++i) {
+            total.clears[i] += stats.clears[i];
+        }
+    }
+    double games = std::max(1, options.games);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Games:       " << options.games << " on " << pool.getThreadCount() << " threads (" << pool.getStealCount() << " jobs stolen)" << std::endl;
+    std::cout << "Elapsed:     " << seconds << " s" << std::endl;
+    std::cout << "Games/sec:   " << options.games / seconds << std::endl;
+    std::cout << "Pieces/sec:  " << totalPieces / seconds << std::endl;
+    std::cout << "Pieces:      " << totalPieces << " (" << totalPieces / games << " per game)" << std::endl;
+    std::cout << "Lines:       " << totalLines << " (" << totalLines / games << " per game)" << std::endl;
+    std::cout << "Clears:      " << total.clears[0] << " single, " << total.clears[1] << " double, "
+              << total.clears[2] << " triple, " << total.clears[3] << " tetris" << std::endl;
+    std::cout << "Score:       " << totalScore / games << " mean, " << bestScore << " best" << std::endl;
+    if (totalTicks > 0) {
+        double gameSeconds = static_cast<double>(totalTicks) / GameCore::TICKS_PER_SECOND;
+        std::cout << "Game time:   " << gameSeconds / 3600.0 << " h simulated (" << gameSeconds / seconds << "x real time)" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include "tetromino_env.h"
+#include "BatchEnv.h"
+#include <exception>
+
+// The C handle is the BatchEnv itself
+struct TetrominoEnv : BatchEnv {
+    using BatchEnv::BatchEnv;
+};
+
+TetrominoEnv* tetromino_env_create(int count, uint32_t seed, int threads, uint32_t ticks_per_step) {
+    if (count <= 0 || threads < 0) return nullptr;
+    try {
+        return new TetrominoEnv(count, seed, static_cast<unsigned>(threads), ticks_per_step);
+    } catch (const std::exception&) { // Out of memory or threads; nothing may escape into C
+        return nullptr;
+    }
+}
+
+void tetromino_env_destroy(TetrominoEnv* env) {
+    delete env;
+}
+
+int tetromino_env_count(const TetrominoEnv* env) {
+    return env ? env->getCount() : 0;
+}
+
+void tetromino_env_set_buffers(TetrominoEnv* env, const TetrominoEnvBuffers* buffers) {
+    if (env && buffers) env->setBuffers(*buffers);
+}
+
+void tetromino_env_reset(TetrominoEnv* env) {
+    if (env) env->reset();
+}
+
+void tetromino_env_step(TetrominoEnv* env, const uint8_t* actions) {
+    if (env && actions) env->step(actions);
+}